@@ -0,0 +1,347 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <ostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <factorization/galois_field/field_element_wrapper.hpp>
+#include <factorization/galois_field/log_based_field.hpp>
+#include <factorization/galois_field/prime_ring.hpp>
+
+#include <factorization/polynomial/half_gcd.hpp>
+#include <factorization/polynomial/hybrid_engine.hpp>
+#include <factorization/polynomial/karatsuba_engine.hpp>
+#include <factorization/polynomial/ntt_engine.hpp>
+#include <factorization/polynomial/tuning.hpp>
+
+#include <factorization/concepts.hpp>
+
+// Times the competing algorithms of HybridEngine on this machine and writes
+// the crossover points as MachineProfile specializations:
+//   ./autotune ../factorization/polynomial/tuning_profile.hpp
+// Without a path the profile is printed to stdout. Rebuild after writing
+// the profile, engines read it at compile time, see tuning.hpp.
+//
+// Half-GCD is timed on HybridEngine, whose thresholds are template
+// arguments, so the first run keeps the Half-GCD parameters of the
+// compiled-in profile. Once the new profile is built, a second run tunes
+// them on top of it and keeps the rest:
+//   ./autotune --half-gcd ../factorization/polynomial/tuning_profile.hpp
+
+using namespace factorization;  // NOLINT
+using Clock = std::chrono::steady_clock;
+using polynomial::Thresholds;
+
+constexpr static int kRounds = 5;
+constexpr static auto kMinRoundTime = std::chrono::milliseconds(5);
+
+constexpr static std::array<size_t, 8> kKaratsubaCandidates{
+    16, 24, 32, 48, 64, 96, 128, 192};
+constexpr static std::array<size_t, 5> kHalfGcdCandidates{32,  64,  128,
+                                                          256, 512};
+
+// Sizes of the sweeps looking for crossover points.
+constexpr static std::array<size_t, 12> kSmallSizes{
+    16, 24, 32, 48, 64, 96, 128, 192, 256, 384, 512, 768};
+constexpr static std::array<size_t, 12> kDivisionSizes{
+    32, 48, 64, 96, 128, 192, 256, 384, 512, 1024, 2048, 4096};
+constexpr static std::array<size_t, 5> kKroneckerSizes{2048, 4096, 8192,
+                                                       16384, 32768};
+constexpr static std::array<size_t, 9> kGcdSizes{
+    256, 512, 1024, 2048, 4096, 8192, 16384, 32768, 65536};
+// Size of the gcd timed to choose the step of Half-GCD.
+constexpr static size_t kHalfGcdStepSize = 16384;
+
+// Best time of one call in nanoseconds.
+template <typename Func>
+double Measure(Func&& func) {
+  double best = 0;
+  for (int round = 0; round < kRounds; ++round) {
+    size_t calls = 0;
+    const auto start = Clock::now();
+    auto finish = start;
+    do {
+      func();
+      ++calls;
+      finish = Clock::now();
+    } while (finish - start < kMinRoundTime);
+    const double time =
+        std::chrono::duration<double, std::nano>(finish - start).count() /
+        static_cast<double>(calls);
+    if (round == 0 || time < best) {
+      best = time;
+    }
+  }
+  return best;
+}
+
+// The first size from which fast is not slower than slow on every larger
+// size of the sweep.
+template <size_t kCount, typename Slow, typename Fast>
+size_t Crossover(const std::array<size_t, kCount>& sizes, Slow&& slow,
+                 Fast&& fast) {
+  size_t result = Thresholds::kNever;
+  for (size_t i = kCount; i-- > 0;) {
+    if (fast(sizes[i]) > slow(sizes[i])) {
+      break;
+    }
+    result = sizes[i];
+  }
+  return result;
+}
+
+// Returns func.template operator()<kValues[index]>(), so that a value
+// chosen at runtime can be used as a template argument.
+template <auto kValues, typename Func>
+auto Dispatch(size_t index, Func&& func) {
+  return [&]<size_t... I>(std::index_sequence<I...>) {
+    decltype(func.template operator()<kValues[0]>()) result{};
+    ((index == I && (result = func.template operator()<kValues[I]>(), true)),
+     ...);
+    return result;
+  }(std::make_index_sequence<kValues.size()>());
+}
+
+template <concepts::GaloisFieldElement Elem>
+class Tuner {
+ public:
+  explicit Tuner(uint64_t seed) : random_gen_(seed) {
+  }
+
+  Thresholds Run(bool half_gcd) {
+    const auto compiled = polynomial::DefaultThresholds<Elem>();
+    if (half_gcd) {
+      auto result = compiled;
+      TuneHalfGcd(result);
+      return result;
+    }
+
+    const size_t karatsuba_index = TuneKaratsuba();
+    auto result = Dispatch<kKaratsubaCandidates>(
+        karatsuba_index, [&]<size_t kKaratsuba>() {
+          return TuneProducts<kKaratsuba>();
+        });
+    result.half_gcd = compiled.half_gcd;
+    result.half_gcd_min = compiled.half_gcd_min;
+    return result;
+  }
+
+ private:
+  std::vector<Elem> RandomPoly(size_t size) {
+    std::vector<Elem> result(size);
+    for (auto& value : result) {
+      std::array<typename Elem::Coefficient, Elem::FieldPower()> coefficients;
+      for (auto& coefficient : coefficients) {
+        coefficient = static_cast<typename Elem::Coefficient>(
+            random_gen_() % Elem::FieldBase());
+      }
+      value = Elem(coefficients);
+    }
+    result.back() = Elem::One();
+    return result;
+  }
+
+  template <size_t kKaratsuba>
+  Thresholds TuneProducts() {
+    using Karatsuba = polynomial::KaratsubaEngine<Elem, kKaratsuba>;
+    using Plain =
+        polynomial::KaratsubaEngine<Elem, kKaratsuba, Thresholds::kNever>;
+    using NewtonKaratsuba = polynomial::KaratsubaEngine<Elem, kKaratsuba, 0>;
+
+    Thresholds result;
+    result.karatsuba = kKaratsuba;
+    if constexpr (Elem::FieldPower() == 1) {
+      using Ntt = polynomial::NttEngine<Elem>;
+      using NewtonNtt = polynomial::NttEngine<Elem, 0>;
+      result.ntt = Crossover(kSmallSizes, MulTime<Karatsuba>(), MulTime<Ntt>());
+      result.ntt_division = Crossover(
+          kDivisionSizes, RemTime<NewtonKaratsuba>(), RemTime<NewtonNtt>());
+      auto newton = [karatsuba = RemTime<NewtonKaratsuba>(),
+                     ntt = RemTime<NewtonNtt>()](size_t size) {
+        return std::min(karatsuba(size), ntt(size));
+      };
+      result.plain_division =
+          Crossover(kDivisionSizes, RemTime<Plain>(), newton);
+    } else {
+      using Kronecker = polynomial::HybridEngine<
+          Elem, Thresholds{.karatsuba = kKaratsuba, .kronecker = 0}>;
+      result.kronecker = Crossover(kKroneckerSizes, MulTime<Karatsuba>(),
+                                   MulTime<Kronecker>());
+      result.plain_division = Crossover(kDivisionSizes, RemTime<Plain>(),
+                                        RemTime<NewtonKaratsuba>());
+    }
+    result.ntt_division = std::max(result.ntt_division, result.plain_division);
+    return result;
+  }
+
+  // Half-GCD is tuned on top of the compiled-in profile of the field, which
+  // is the one HybridEngine<Elem> is instantiated on.
+  void TuneHalfGcd(Thresholds& result) {
+    using Engine = polynomial::HybridEngine<Elem>;
+    size_t best_index = 0;
+    double best_time = 0;
+    for (size_t i = 0; i < kHalfGcdCandidates.size(); ++i) {
+      const double time =
+          Dispatch<kHalfGcdCandidates>(i, [&]<size_t kThreshold>() {
+            using Gcd = polynomial::HalfGcd<Elem, Engine, kThreshold, 0>;
+            return GcdTime<Gcd>()(kHalfGcdStepSize);
+          });
+      if (i == 0 || time < best_time) {
+        best_index = i;
+        best_time = time;
+      }
+    }
+    result.half_gcd = kHalfGcdCandidates[best_index];
+    result.half_gcd_min = Dispatch<kHalfGcdCandidates>(
+        best_index, [&]<size_t kThreshold>() {
+          using Euclid = polynomial::HalfGcd<Elem, Engine, kThreshold,
+                                             Thresholds::kNever>;
+          using Fast = polynomial::HalfGcd<Elem, Engine, kThreshold, 0>;
+          return Crossover(kGcdSizes, GcdTime<Euclid>(), GcdTime<Fast>());
+        });
+  }
+
+  size_t TuneKaratsuba() {
+    constexpr std::array<size_t, 2> kSizes{512, 2048};
+    size_t best_index = 0;
+    double best_time = 0;
+    for (size_t i = 0; i < kKaratsubaCandidates.size(); ++i) {
+      const double time =
+          Dispatch<kKaratsubaCandidates>(i, [&]<size_t kThreshold>() {
+            auto mul_time =
+                MulTime<polynomial::KaratsubaEngine<Elem, kThreshold>>();
+            double total = 0;
+            for (const size_t size : kSizes) {
+              total += mul_time(size);
+            }
+            return total;
+          });
+      if (i == 0 || time < best_time) {
+        best_index = i;
+        best_time = time;
+      }
+    }
+    return best_index;
+  }
+
+  template <typename Engine>
+  auto MulTime() {
+    return [this](size_t size) {
+      const auto a = RandomPoly(size);
+      const auto b = RandomPoly(size);
+      return Measure([&] { (void)Engine::Mul(a, b); });
+    };
+  }
+
+  // Division of 2n coefficients by n coefficients.
+  template <typename Engine>
+  auto RemTime() {
+    return [this](size_t size) {
+      const auto a = RandomPoly(2 * size);
+      const auto b = RandomPoly(size);
+      return Measure([&] { (void)Engine::Rem(a, b); });
+    };
+  }
+
+  // Gcd of two polynomials of the given size with a common factor.
+  template <typename Gcd>
+  auto GcdTime() {
+    return [this](size_t size) {
+      const auto common = RandomPoly(size / 4);
+      const auto a = polynomial::HybridEngine<Elem>::Mul(
+          RandomPoly(size - size / 4), common);
+      const auto b = polynomial::HybridEngine<Elem>::Mul(
+          RandomPoly(size - size / 4 - 1), common);
+      return Measure([&] { (void)Gcd::Gcd(a, b); });
+    };
+  }
+
+  std::mt19937_64 random_gen_;
+};
+
+void Print(std::ostream& out, const Thresholds& thresholds) {
+  auto value = [](size_t threshold) {
+    return threshold == Thresholds::kNever
+               ? std::string("Thresholds::kNever")
+               : std::to_string(threshold);
+  };
+  out << "  constexpr static Thresholds kThresholds{\n"
+      << "      .karatsuba = " << value(thresholds.karatsuba) << ",\n"
+      << "      .ntt = " << value(thresholds.ntt) << ",\n"
+      << "      .kronecker = " << value(thresholds.kronecker) << ",\n"
+      << "      .plain_division = " << value(thresholds.plain_division)
+      << ",\n"
+      << "      .ntt_division = " << value(thresholds.ntt_division) << ",\n"
+      << "      .half_gcd = " << value(thresholds.half_gcd) << ",\n"
+      << "      .half_gcd_min = " << value(thresholds.half_gcd_min) << ",\n"
+      << "  };\n";
+}
+
+template <concepts::GaloisFieldElement Elem>
+void Tune(const char* label, std::ostream& out, bool half_gcd) {
+  std::cerr << "tuning " << label << "\n";
+  const auto thresholds = Tuner<Elem>(0).Run(half_gcd);
+  out << "\n// " << label << "\n"
+      << "template <>\n"
+      << "struct MachineProfile<" << Elem::FieldBase() << ", "
+      << Elem::FieldPower() << "> {\n";
+  Print(out, thresholds);
+  out << "};\n";
+}
+
+int main(int argc, char** argv) {
+  bool half_gcd = false;
+  const char* path = nullptr;
+  for (int i = 1; i < argc; ++i) {
+    if (std::string(argv[i]) == "--half-gcd") {
+      half_gcd = true;
+    } else {
+      path = argv[i];
+    }
+  }
+
+  std::ofstream file;
+  if (path != nullptr) {
+    file.open(path);
+    if (!file) {
+      std::cerr << "cannot open " << path << "\n";
+      return 1;
+    }
+  }
+  std::ostream& out = path != nullptr ? file : std::cout;
+
+  out << "// Generated by benchmarks/autotune.cpp, do not edit.\n\n"
+      << "#pragma once\n\n"
+      << "namespace factorization::polynomial {\n";
+
+  {
+    using Z_p = galois_field::PrimeRing<17>;
+    Tune<galois_field::FieldElementWrapper<Z_p>>("Z_17", out, half_gcd);
+  }
+
+  {
+    using Z_p = galois_field::PrimeRing<1000003, uint64_t, __int128_t>;
+    Tune<galois_field::FieldElementWrapper<Z_p>>("Z_1000003", out, half_gcd);
+  }
+
+  {
+    using GF2_3 = galois_field::LogBasedField<2, 3, {1, 1, 0, 1}>;
+    Tune<galois_field::FieldElementWrapper<GF2_3>>("GF2^3", out, half_gcd);
+  }
+
+  {
+    // NOLINTNEXTLINE
+    using GF2_8 = galois_field::LogBasedField<2, 8, {1, 0, 1, 1, 1, 0, 0, 0, 1}>;
+    Tune<galois_field::FieldElementWrapper<GF2_8>>("GF2^8", out, half_gcd);
+  }
+
+  out << "\n}  // namespace factorization::polynomial\n";
+  return 0;
+}
@@ -0,0 +1,128 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <ostream>
+#include <random>
+#include <vector>
+
+#include <factorization/galois_field/field_element_wrapper.hpp>
+#include <factorization/galois_field/log_based_field.hpp>
+#include <factorization/galois_field/prime_ring.hpp>
+
+#include <factorization/polynomial/generic_polynomial.hpp>
+#include <factorization/polynomial/hybrid_engine.hpp>
+#include <factorization/polynomial/karatsuba_engine.hpp>
+
+#include <factorization/concepts.hpp>
+#include <factorization/solver/factorizer.hpp>
+
+#include "generator.hpp"
+
+// Factorizer with the plans of its cost model against every fixed plan. Each
+// cell is the time of the automatic choice, then the times of Berlekamp, DDF
+// with kSmallField and DDF with kExactNtl, and the ratio of the automatic
+// time to the best fixed one.
+
+using namespace factorization;  // NOLINT
+using Clock = std::chrono::steady_clock;
+
+constexpr static int kRunCount = 2;
+constexpr static std::array<int, 3> kSizes{50, 200, 800};
+
+template <concepts::Polynom Poly>
+double Measure(const solver::Factorizer<Poly>& factorizer, int size) {
+  std::mt19937_64 random_gen(size);
+  Clock::duration total{};
+  for (int run = 0; run < kRunCount; ++run) {
+    const Poly poly = GenPoly<Poly>(random_gen, size);
+    const auto start = Clock::now();
+    (void)factorizer.Factorize(poly, random_gen);
+    total += Clock::now() - start;
+  }
+  return std::chrono::duration<double, std::milli>(total).count() / kRunCount;
+}
+
+template <concepts::Polynom Poly>
+void Simulate(const char* label, std::ostream& out) {
+  using solver::FactorizationMethod;
+  using solver::FactorizationPlan;
+
+  out << label << "\n";
+  for (const int size : kSizes) {
+    const double automatic = Measure(solver::Factorizer<Poly>(), size);
+    std::vector<double> fixed = {Measure(
+        solver::Factorizer<Poly>(
+            FactorizationPlan{FactorizationMethod::kBerlekamp}),
+        size)};
+    for (const auto mode : {ddf::kSmallField, ddf::kExactNtl}) {
+      fixed.push_back(Measure(
+          solver::Factorizer<Poly>(
+              FactorizationPlan{FactorizationMethod::kDistinctDegree, mode}),
+          size));
+    }
+
+    const auto plan = solver::Factorizer<Poly>::ChoosePlan(size);
+    out << "  n = " << size << "\tauto ";
+    if (plan.method == FactorizationMethod::kBerlekamp) {
+      out << "(berlekamp)";
+    } else if (plan.steps_mode == ddf::kSmallField) {
+      out << "(small_field)";
+    } else {
+      out << "(exact_ntl)";
+    }
+    out << std::setprecision(1) << std::fixed << " " << automatic << " ms\t";
+    const char* names[] = {"berlekamp", "small_field", "exact_ntl"};
+    for (size_t i = 0; i < fixed.size(); ++i) {
+      out << names[i] << " " << fixed[i] << " ms\t";
+    }
+    out << std::setprecision(2) << "x"
+        << automatic / *std::min_element(fixed.begin(), fixed.end()) << "\n";
+  }
+  out << "\n";
+}
+
+template <concepts::GaloisFieldElement Element>
+void SimulateEngines(const char* label, std::ostream& out) {
+  using Karatsuba = polynomial::KaratsubaEngine<Element>;
+  using Hybrid = polynomial::HybridEngine<Element>;
+  out << label << "\n";
+  Simulate<polynomial::GenericPolynomial<Element, Karatsuba>>("karatsuba", out);
+  Simulate<polynomial::GenericPolynomial<Element, Hybrid>>("hybrid", out);
+}
+
+int main() {
+  {
+    using Z_2 = galois_field::LogBasedField<2, 1, {1, 1}>;
+    SimulateEngines<galois_field::FieldElementWrapper<Z_2>>("Z_2", std::cout);
+  }
+
+  {
+    using GF3_2 = galois_field::LogBasedField<3, 2, {2, 2, 1}>;
+    SimulateEngines<galois_field::FieldElementWrapper<GF3_2>>("GF3^2",
+                                                              std::cout);
+  }
+
+  {
+    // NOLINTNEXTLINE
+    using GF2_8 = galois_field::LogBasedField<2, 8, {1, 0, 1, 1, 1, 0, 0, 0, 1}>;
+    SimulateEngines<galois_field::FieldElementWrapper<GF2_8>>("GF2^8",
+                                                              std::cout);
+  }
+
+  {
+    using Z_p = galois_field::PrimeRing<101, uint64_t, __int128_t>;
+    SimulateEngines<galois_field::FieldElementWrapper<Z_p>>("Z_101", std::cout);
+  }
+
+  {
+    using Z_p = galois_field::PrimeRing<1000003, uint64_t, __int128_t>;
+    SimulateEngines<galois_field::FieldElementWrapper<Z_p>>("Z_1000003",
+                                                            std::cout);
+  }
+
+  return 0;
+}
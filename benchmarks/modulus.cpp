@@ -0,0 +1,125 @@
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <ostream>
+#include <random>
+#include <vector>
+
+#include <factorization/galois_field/field_element_wrapper.hpp>
+#include <factorization/galois_field/log_based_field.hpp>
+#include <factorization/galois_field/prime_ring.hpp>
+
+#include <factorization/polynomial/generic_polynomial.hpp>
+#include <factorization/polynomial/hybrid_engine.hpp>
+
+#include <factorization/concepts.hpp>
+#include <factorization/solver/distinct_degree_factorization.hpp>
+#include <factorization/solver/square_free_factorization.hpp>
+
+#include "generator.hpp"
+
+// Share of the DDF time spent in building moduli. TimedEngine forwards
+// everything to the wrapped engine and accumulates the time of BuildModulus
+// and RebuildModulus.
+
+using namespace factorization;  // NOLINT
+using Clock = std::chrono::steady_clock;
+
+constexpr static int kRunCount = 2;
+constexpr static std::array<int, 2> kSizes{1000, 2000};
+
+template <concepts::GaloisFieldElement Elem, typename Engine>
+struct TimedEngine : Engine {
+  using typename Engine::Modulus;
+
+  [[nodiscard]]
+  static Modulus BuildModulus(const std::vector<Elem>& polynomial,
+                              size_t max_dividend_size) {
+    const auto start = Clock::now();
+    auto result = Engine::BuildModulus(polynomial, max_dividend_size);
+    modulus_time += Clock::now() - start;
+    return result;
+  }
+
+  [[nodiscard]]
+  static Modulus RebuildModulus(const Modulus& modulus,
+                                const std::vector<Elem>& polynomial,
+                                const std::vector<Elem>& divisor,
+                                size_t max_dividend_size) {
+    const auto start = Clock::now();
+    auto result = Engine::RebuildModulus(modulus, polynomial, divisor,
+                                         max_dividend_size);
+    modulus_time += Clock::now() - start;
+    return result;
+  }
+
+  inline static Clock::duration modulus_time{};
+};
+
+template <concepts::Polynom Poly, typename Engine, typename Solver>
+void RunSolver(const char* label, std::ostream& out) {
+  out << label << "\t";
+  for (const int size : kSizes) {
+    std::mt19937_64 random_gen(0);
+    Engine::modulus_time = {};
+    Clock::duration total{};
+    for (int run = 0; run < kRunCount; ++run) {
+      const Poly poly = GenPoly<Poly>(random_gen, size);
+      for (const auto& [factor, _] : sff::SquareFreeFactorize(poly)) {
+        Solver solver(factor);
+        const auto start = Clock::now();
+        (void)solver.Run();
+        total += Clock::now() - start;
+      }
+    }
+    using Ms = std::chrono::duration<double, std::milli>;
+    const double total_ms = Ms(total).count() / kRunCount;
+    const double modulus_ms = Ms(Engine::modulus_time).count() / kRunCount;
+    out << std::setprecision(1) << std::fixed << total_ms << " ms, "
+        << modulus_ms << " ms (" << 100 * modulus_ms / total_ms << "%)\t";
+  }
+  out << "\n";
+}
+
+template <concepts::GaloisFieldElement Element>
+void Simulate(const char* label, std::ostream& out) {
+  using Engine = TimedEngine<Element, polynomial::HybridEngine<Element>>;
+  using Poly = polynomial::GenericPolynomial<Element, Engine>;
+  // NOLINTBEGIN
+  using ExactNtl =
+      ddf::ntl_like::DistinctDegreeFactorizer<Poly, ddf::kExactNtl>;
+  using ModifiedNtl =
+      ddf::ntl_like::DistinctDegreeFactorizer<Poly, ddf::kSmallField>;
+  using Lazy = ddf::own_lazy::DistinctDegreeFactorizer<Poly, ddf::kSmallField>;
+  using Tree = ddf::own_tree::DistinctDegreeFactorizer<Poly, ddf::kSmallField>;
+  // NOLINTEND
+
+  out << label << "\t";
+  for (const int size : kSizes) {
+    out << size << "\t\t";
+  }
+  out << "\n";
+  RunSolver<Poly, Engine, ExactNtl>("exact_ntl", out);
+  RunSolver<Poly, Engine, ModifiedNtl>("modified_ntl", out);
+  RunSolver<Poly, Engine, Lazy>("lazy", out);
+  RunSolver<Poly, Engine, Tree>("tree", out);
+  out << "\n";
+}
+
+int main() {
+  {
+    // NOLINTNEXTLINE
+    using GF2_8 = galois_field::LogBasedField<2, 8, {1, 0, 1, 1, 1, 0, 0, 0, 1}>;
+    Simulate<galois_field::FieldElementWrapper<GF2_8>>("GF2^8", std::cout);
+  }
+
+  {
+    using Z_p = galois_field::PrimeRing<1000003, uint64_t, __int128_t>;
+    Simulate<galois_field::FieldElementWrapper<Z_p>>("Z_1000003", std::cout);
+  }
+
+  return 0;
+}
@@ -26,6 +26,8 @@
 #include <concepts>
 #include <cstddef>
 #include <ranges>
+#include <span>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -106,6 +108,7 @@ concept PolynomialEngine =
     requires(std::vector<Elem> lhs, const std::vector<Elem>& rhs,
              const typename Engine::Modulus& modulus) {
       { Engine::Mul(std::move(lhs), rhs) } -> std::same_as<std::vector<Elem>>;
+      { Engine::Sqr(rhs) } -> std::same_as<std::vector<Elem>>;
       { Engine::Div(std::move(lhs), rhs) } -> std::same_as<std::vector<Elem>>;
       { Engine::Rem(std::move(lhs), rhs) } -> std::same_as<std::vector<Elem>>;
       {
@@ -114,6 +117,11 @@ concept PolynomialEngine =
       {
         Engine::Gcd(std::vector<Elem>{}, std::vector<Elem>{})
       } -> std::same_as<std::vector<Elem>>;
+      {
+        Engine::XGcd(std::vector<Elem>{}, std::vector<Elem>{})
+      } -> std::same_as<std::tuple<std::vector<Elem>, std::vector<Elem>,
+                                   std::vector<Elem>>>;
+      { Engine::InvMod(std::move(lhs), rhs) } -> std::same_as<std::vector<Elem>>;
       // operations with some precomputations
       // this makes massive calculations of the form
       //   a * b (mod f)
@@ -149,11 +157,16 @@ concept Polynom = requires(const Poly& poly, typename Poly::Element value,
   { poly.Add(poly) } -> std::same_as<Poly>;
   { poly.Sub(poly) } -> std::same_as<Poly>;
   { poly.Mul(poly) } -> std::same_as<Poly>;
+  { poly.Sqr() } -> std::same_as<Poly>;
   { poly.Div(poly) } -> std::same_as<Poly>;
   { poly.Rem(poly) } -> std::same_as<Poly>;
   // <quotient, remainder>
   { poly.DivRem(poly) } -> std::same_as<std::pair<Poly, Poly>>;
   { poly.Gcd(poly) } -> std::same_as<Poly>;
+  // <gcd, s, t> with s * poly + t * other = gcd, gcd is monic
+  { poly.XGcd(poly) } -> std::same_as<std::tuple<Poly, Poly, Poly>>;
+  // inverse modulo the argument, zero if it does not exist
+  { poly.InvMod(poly) } -> std::same_as<Poly>;
   { poly.MakeMonic() } -> std::same_as<Poly>;
   { poly.Derivative() } -> std::same_as<Poly>;
 
@@ -172,6 +185,8 @@ concept Polynom = requires(const Poly& poly, typename Poly::Element value,
   //   a[0] + a[1] x + a[2] x^2 + ... + a[n] x^n
   // From lower power to higher
   { poly.Get() } -> std::same_as<std::vector<typename Poly::Element>>;
+  // the same coefficients without a copy
+  { poly.View() } -> std::same_as<std::span<const typename Poly::Element>>;
   // return polynomial degree + 1 if the polynomial is nonzero
   // otherwise return zero
   { poly.Size() } -> std::integral;
@@ -22,13 +22,21 @@
 
 #pragma once
 
+#include <algorithm>
+#include <array>
 #include <cassert>
+#include <cmath>
 #include <concepts>
 #include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <span>
 #include <utility>
 #include <vector>
 
 #include <factorization/concepts.hpp>
+#include <factorization/utils.hpp>
 
 namespace factorization::polynomial {
 
@@ -46,12 +54,123 @@ Poly BinPowMod(Poly poly, Int pow, const typename Poly::Modulus& mod) {
     }
     pow /= 2;
     if (pow > 0) {
-      poly = poly.Mul(poly).Rem(mod);
+      poly = std::move(poly).Sqr().Rem(mod);
     }
   }
   return result;
 }
 
+/*! @brief Builds the modulus of poly from the modulus of poly * divisor.
+ *
+ *  Polynomials that can rebuild a modulus reuse its precomputations, see
+ *  GenericPolynomial::RebuildModulus, others build it anew. This is the case
+ *  of DDF, which keeps dividing the current modulus by the extracted factors.
+ *
+ *  @pre mod was built for poly * divisor up to a constant factor.
+ */
+template <concepts::Polynom Poly>
+typename Poly::Modulus RebuildModulus(const Poly& poly,
+                                      const typename Poly::Modulus& mod,
+                                      const Poly& divisor,
+                                      size_t max_dividend_size) {
+  if constexpr (requires { poly.RebuildModulus(mod, divisor, size_t{}); }) {
+    return poly.RebuildModulus(mod, divisor, max_dividend_size);
+  } else {
+    return poly.BuildModulus(max_dividend_size);
+  }
+}
+
+/*! @brief Fields with a base up to this value compute the Frobenius map by
+ *  coefficient spreading, larger ones fall back to BinPowMod.
+ *
+ *  Spreading needs about p - 1 reductions of a dividend of size 2n per
+ *  characteristic power, binary exponentiation needs log2(p) squarings plus
+ *  multiplications by poly, each followed by a reduction.
+ */
+inline constexpr int kFrobeniusSpreadMaxBase = 5;
+
+/*! @brief Computes poly^p (mod f), where p is the field characteristic.
+ *
+ *  In characteristic p the map a -> a^p is additive, so
+ *    (c_0 + c_1 x + ... + c_{n-1} x^{n-1})^p
+ *      = c_0^p + c_1^p x^p + ... + c_{n-1}^p x^{(n-1)p}.
+ *  The coefficients are only spread, the single nontrivial part is the
+ *  reduction modulo f.
+ *
+ *  @pre poly is already reduced modulo mod.
+ */
+template <concepts::Polynom Poly>
+Poly CharacteristicPowerMod(const Poly& poly,
+                            const typename Poly::Modulus& mod) {
+  using Element = typename Poly::Element;
+  constexpr auto kBase = static_cast<size_t>(Element::FieldBase());
+
+  const auto coefficients = poly.View();
+  if (coefficients.empty()) {
+    return Poly();
+  }
+  const size_t n = coefficients.size();
+
+  std::vector<Element> spread((n - 1) * kBase + 1, Element::Zero());
+  for (size_t i = 0; i < n; ++i) {
+    if constexpr (Element::FieldPower() == 1) {
+      // c^p = c over a prime field
+      spread[i * kBase] = coefficients[i];
+    } else {
+      spread[i * kBase] = coefficients[i].Pow(kBase);
+    }
+  }
+
+  // Dividends passed to mod must stay within its precomputed capacity, which
+  // is at least twice the size of f. The spread polynomial is split into
+  // blocks of n coefficients,
+  //   spread = s_0 + s_1 x^n + ... + s_k x^{kn},
+  // and reduced by Horner's rule
+  //   result <- result * x^n + s_j (mod f).
+  // Multiplication by x^n is only a shift, the dividend is the concatenation
+  // of s_j and result, so its size stays below 2 deg f.
+  size_t block_count = 1;
+  if (spread.size() > 2 * n) {
+    block_count += (spread.size() - n) / n;
+  }
+  size_t from = (block_count - 1) * n;
+  Poly result =
+      Poly(std::vector<Element>(spread.begin() + from, spread.end())).Rem(mod);
+  while (from > 0) {
+    from -= n;
+    std::vector<Element> dividend(spread.begin() + from,
+                                  spread.begin() + from + n);
+    if (!result.IsZero()) {
+      const auto rest = std::move(result).Get();
+      dividend.insert(dividend.end(), rest.begin(), rest.end());
+    }
+    result = Poly(std::move(dividend)).Rem(mod);
+  }
+  return result;
+}
+
+/*! @brief Computes poly^q (mod f), where q is the field size.
+ *
+ *  For a small characteristic p the q-th power is computed as log_p(q)
+ *  applications of CharacteristicPowerMod, otherwise by BinPowMod.
+ *
+ *  @pre poly is already reduced modulo mod.
+ */
+template <concepts::Polynom Poly>
+Poly FrobeniusMod(Poly poly, const typename Poly::Modulus& mod) {
+  using Element = typename Poly::Element;
+  if constexpr (Element::FieldBase() <= kFrobeniusSpreadMaxBase) {
+    for (int i = 0; i < static_cast<int>(Element::FieldPower()); ++i) {
+      poly = CharacteristicPowerMod(poly, mod);
+    }
+    return poly;
+  } else {
+    constexpr auto kFieldSize =
+        utils::BinPow(Element::FieldBase(), Element::FieldPower());
+    return BinPowMod(std::move(poly), kFieldSize, mod);
+  }
+}
+
 /*! @brief Builds a power table for modular composition.
  *
  *  For a composition argument h, the returned matrix stores the coefficient
@@ -103,7 +222,118 @@ void UpdateCompModMatrix(
   }
 }
 
-/*! @brief Computes poly(h) (mod f) using a precomputed power table.
+namespace detail {
+
+// Column tile of MulBlocks: rows of H restricted to a tile stay in cache
+// while every block row is multiplied by them.
+inline constexpr size_t kCompModColumnTile = 512;
+
+/*! @brief Returns the products g * H for every block g, where H consists of
+ *  rows h^0, ..., h^{t-1} of the power table.
+ *
+ *  Over prime fields with p < 2^32 the product is done on integers: every
+ *  entry of the result is a sum of at most t products below p^2, which is
+ *  accumulated in 64 bits and reduced only when it could overflow. The
+ *  columns are processed in tiles, so a tile of H is reused by all blocks.
+ *  Other fields multiply elements directly.
+ */
+template <concepts::GaloisFieldElement Element>
+std::vector<std::vector<Element>> MulBlocks(
+    const std::vector<std::span<const Element>>& blocks,
+    const std::vector<std::vector<Element>>& matrix) {
+  const size_t t = matrix.size() - 1;
+  size_t width = 0;
+  for (size_t i = 0; i < t; ++i) {
+    width = std::max(width, matrix[i].size());
+  }
+  std::vector<std::vector<Element>> result(blocks.size());
+
+  if constexpr (Element::FieldPower() == 1 &&
+                Element::FieldBase() <= std::numeric_limits<uint32_t>::max()) {
+    using Coefficients = std::array<typename Element::Coefficient, 1>;
+    const uint64_t p = Element::FieldBase();
+    // The accumulator stays below p + max_terms (p - 1)^2 < 2^64.
+    const uint64_t max_terms =
+        (std::numeric_limits<uint64_t>::max() - p) / ((p - 1) * (p - 1));
+
+    std::vector<uint32_t> h(t * width, 0);
+    for (size_t i = 0; i < t; ++i) {
+      for (size_t j = 0; j < matrix[i].size(); ++j) {
+        h[i * width + j] = static_cast<uint32_t>(matrix[i][j].Get()[0]);
+      }
+    }
+    std::vector<uint32_t> g(blocks.size() * t, 0);
+    for (size_t b = 0; b < blocks.size(); ++b) {
+      for (size_t i = 0; i < blocks[b].size(); ++i) {
+        g[b * t + i] = static_cast<uint32_t>(blocks[b][i].Get()[0]);
+      }
+      result[b].resize(width);
+    }
+
+    std::vector<uint64_t> sums(kCompModColumnTile);
+    for (size_t from = 0; from < width; from += kCompModColumnTile) {
+      const size_t size = std::min(kCompModColumnTile, width - from);
+      for (size_t b = 0; b < blocks.size(); ++b) {
+        std::fill(sums.begin(), sums.begin() + size, 0);
+        uint64_t terms = 0;
+        for (size_t i = 0; i < t; ++i) {
+          const uint64_t c = g[b * t + i];
+          if (c == 0) {
+            continue;
+          }
+          if (terms == max_terms) {
+            for (size_t j = 0; j < size; ++j) {
+              sums[j] %= p;
+            }
+            terms = 0;
+          }
+          const uint32_t* row = h.data() + i * width + from;
+          for (size_t j = 0; j < size; ++j) {
+            sums[j] += c * row[j];
+          }
+          ++terms;
+        }
+        for (size_t j = 0; j < size; ++j) {
+          result[b][from + j] = Element(Coefficients{
+              static_cast<typename Element::Coefficient>(sums[j] % p)});
+        }
+      }
+    }
+  } else {
+    for (size_t b = 0; b < blocks.size(); ++b) {
+      // A local vector: small elements may alias the storage of result, so
+      // writing through result[b] would reload its data pointer every time.
+      std::vector<Element> block;
+      for (size_t i = 0; i < blocks[b].size(); ++i) {
+        const auto& c = blocks[b][i];
+        if (c == Element::Zero()) {
+          continue;
+        }
+        // row is h^i (mod f).
+        const auto& row = matrix[i];
+        if (block.size() < row.size()) {
+          block.resize(row.size(), Element::Zero());
+        }
+        for (size_t j = 0; j < row.size(); ++j) {
+          block[j] += c * row[j];
+        }
+      }
+      result[b] = std::move(block);
+    }
+  }
+
+  for (auto& block : result) {
+    while (!block.empty() && block.back() == Element::Zero()) {
+      block.pop_back();
+    }
+  }
+  return result;
+}
+
+}  // namespace detail
+
+/*! @brief Computes poly(h) (mod f) for every poly using a precomputed power
+ *  table.
  *
  *  The matrix must be produced by BuildCompModMatrix(h, t, mod) or updated by
  *  UpdateCompModMatrix for the same h.
@@ -119,21 +349,19 @@ void UpdateCompModMatrix(
  *  Then these values are combined by Horner's rule with
  *    h^t (mod f),
  *  which is stored as the last row of the table.
+ *
+ *  Blocks of all polynomials go to a single matrix product, which shares the
+ *  table between them.
  */
 template <concepts::Polynom Poly>
-Poly CompMod(const Poly& poly,
-             const std::vector<std::vector<typename Poly::Element>>& matrix,
-             const typename Poly::Modulus& mod) {
+std::vector<Poly> CompModMany(
+    const std::vector<Poly>& polys,
+    const std::vector<std::vector<typename Poly::Element>>& matrix,
+    const typename Poly::Modulus& mod) {
   assert(matrix.size() >= 2);
   using Element = typename Poly::Element;
 
-  const auto coefficients = poly.Get();
-  if (coefficients.empty()) {
-    return Poly();
-  }
   const size_t t = matrix.size() - 1;
-  const size_t n = coefficients.size();
-  const size_t block_count = (n + t - 1) / t;
 
   // Write
   //   poly(x) = c_0 x^0 + ... + c_{n-1} x^{n-1}
@@ -143,48 +371,268 @@ Poly CompMod(const Poly& poly,
   //   [ ...                 ] * [ ...             ] = G * H.
   //   [ g_{block_count - 1} ]   [ h^{t-1} (mod f) ]
   // Polynomials in the matrices above are coefficient row vectors.
-  // G is not computed directly, H is stored in the precomputed table.
-  std::vector<Poly> blocks(block_count);
-  for (size_t block_id = 0; block_id < block_count; ++block_id) {
-    std::vector<Element> block;
-    const size_t from = block_id * t;
-    // The block row is
-    //   g_{block_id}(x) = c_{from} + ... + c_{from + t - 1} x^{t-1}.
-    // The last block may contain fewer than t coefficients.
-    // This iteration computes
-    //   g_{block_id}(h) (mod f) = g_{block_id} * H.
-    // Result is stored in variable `block`.
-    // The loop order is chosen to be more cache-friendly.
-    for (size_t i = 0; i < t && from + i < n; ++i) {
-      const auto& c = coefficients[from + i];
-      if (c == Element::Zero()) {
-        continue;
-      }
-      // row is h^i (mod f).
-      const auto& row = matrix[i];
-      if (block.size() < row.size()) {
-        block.resize(row.size(), Element::Zero());
-      }
-      for (size_t j = 0; j < row.size(); ++j) {
-        block[j] += c * row[j];
-      }
+  // G stacks the blocks of all polynomials, H is stored in the precomputed
+  // table.
+  std::vector<std::span<const Element>> blocks;
+  for (const auto& poly : polys) {
+    const auto coefficients = poly.View();
+    for (size_t from = 0; from < coefficients.size(); from += t) {
+      blocks.push_back(
+          coefficients.subspan(from, std::min(t, coefficients.size() - from)));
     }
-    blocks[block_id] = Poly(std::move(block));
   }
+  auto values = detail::MulBlocks(blocks, matrix);
 
   // Starting from the highest block, maintain
   //   result <- result * h^t + g_block(h) (mod f).
   // In the end we have
   //   result = g_0(h) + g_1(h) h^t + ... (mod f).
   const Poly block_step(matrix.back());
-  Poly result;
-  for (size_t block = block_count; block-- > 0;) {
-    if (!result.IsZero()) {
-      result = std::move(result).Mul(block_step).Rem(mod);
+  std::vector<Poly> result(polys.size());
+  size_t offset = 0;
+  for (size_t i = 0; i < polys.size(); ++i) {
+    const size_t block_count = (polys[i].Size() + t - 1) / t;
+    for (size_t block = block_count; block-- > 0;) {
+      if (!result[i].IsZero()) {
+        result[i] = std::move(result[i]).Mul(block_step).Rem(mod);
+      }
+      result[i] =
+          std::move(result[i]).Add(Poly(std::move(values[offset + block])));
+    }
+    offset += block_count;
+  }
+  return result;
+}
+
+/*! @brief Computes poly(h) (mod f) using a precomputed power table, see
+ *  CompModMany.
+ */
+template <concepts::Polynom Poly>
+Poly CompMod(const Poly& poly,
+             const std::vector<std::vector<typename Poly::Element>>& matrix,
+             const typename Poly::Modulus& mod) {
+  return std::move(CompModMany(std::vector<Poly>{poly}, matrix, mod)[0]);
+}
+
+/*! @brief Fills table[2], ..., table[count] with iterated compositions
+ *    table[i] = table[i - 1](table[1]) (mod f).
+ *
+ *  All compositions share the power table of table[1]. Computing the iterates
+ *  by doubling would batch the compositions of a round into one product, but
+ *  the power tables of the intermediate iterates cost more than it saves.
+ *
+ *  @pre table.size() > count.
+ */
+template <concepts::Polynom Poly>
+void ComposeIterates(std::vector<Poly>& table, size_t count, size_t t,
+                     const typename Poly::Modulus& mod) {
+  if (count < 2) {
+    return;
+  }
+  const auto matrix = BuildCompModMatrix(table[1], t, mod);
+  for (size_t i = 2; i <= count; ++i) {
+    table[i] = CompMod(table[i - 1], matrix, mod);
+  }
+}
+
+/*! @brief Computes form(1), form(h), ..., form(h^{count-1}) for a linear
+ *  form on polynomials modulo f, the transposed operation of CompMod.
+ *
+ *  The form is given by its values on the monomial basis,
+ *    form[i] = form(x^i),  0 <= i < deg f,
+ *  and the matrix must be produced by BuildCompModMatrix(h, t, mod).
+ *
+ *  Baby steps read form_j(h^i) for i < t off the rows of the table, giant
+ *  steps move to the form
+ *    form_{j+1}(g) = form_j(h^t g (mod f)).
+ *  The giant step uses the sequence s_k = form_j(x^k (mod f)): it satisfies
+ *  the recurrence given by f, so s_n, ..., s_{2n-2} follow from the known
+ *  s_0, ..., s_{n-1} by one power series division by rev(f), and then
+ *    form_{j+1}(x^i) = sum_m (h^t)_m s_{i+m}
+ *  is the middle of one product.
+ *
+ *  @pre f is monic and deg f >= 1.
+ *  @pre form.size() <= deg f.
+ */
+template <concepts::Polynom Poly>
+std::vector<typename Poly::Element> PowerProjection(
+    std::vector<typename Poly::Element> form, size_t count,
+    const std::vector<std::vector<typename Poly::Element>>& matrix,
+    const Poly& f) {
+  assert(matrix.size() >= 2);
+  assert(f.Size() >= 2);
+  using Element = typename Poly::Element;
+
+  const size_t n = f.Size() - 1;
+  const size_t t = matrix.size() - 1;
+  form.resize(n, Element::Zero());
+
+  // rev(f) and 1 / rev(f) (mod z^{n-1}). The latter is the reversed quotient
+  // of x^{2n-2} by f.
+  auto coefficients = f.Get();
+  std::reverse(coefficients.begin(), coefficients.end());
+  const Poly reversed(std::move(coefficients));
+  Poly inverse;
+  if (n > 1) {
+    std::vector<Element> power(2 * n - 1, Element::Zero());
+    power.back() = Element::One();
+    auto quotient = Poly(std::move(power)).Div(f).Get();
+    std::reverse(quotient.begin(), quotient.end());
+    inverse = Poly(std::move(quotient));
+  }
+  auto step = matrix.back();
+  step.resize(n, Element::Zero());
+  std::reverse(step.begin(), step.end());
+  const Poly reversed_step(std::move(step));
+
+  std::vector<std::vector<Element>> forms;
+  const size_t giant_count = (count + t - 1) / t;
+  for (size_t j = 0; j < giant_count; ++j) {
+    if (j > 0) {
+      // s_0, ..., s_{n-1} is the form itself. The coefficients from n on of
+      //   S(z) rev(f)(z)
+      // vanish, so the tail T = s_n + s_{n+1} z + ... satisfies
+      //   T rev(f) = -(form rev(f) div z^n).
+      auto product = reversed.Mul(Poly(form)).Get();
+      product.resize(2 * n, Element::Zero());
+      auto tail =
+          Poly(std::vector<Element>(product.begin() + n, product.end()))
+              .Mul(inverse)
+              .Get();
+      tail.resize(n - 1, Element::Zero());
+      std::vector<Element> sequence = form;
+      for (const auto& value : tail) {
+        sequence.push_back(-value);
+      }
+      auto next = reversed_step.Mul(Poly(std::move(sequence))).Get();
+      next.resize(2 * n - 1, Element::Zero());
+      form.assign(next.begin() + n - 1, next.end());
+    }
+    forms.push_back(form);
+  }
+
+  // form_j(h^i) for all j and i < t is a single product of the forms by the
+  // transposed table. MulBlocks does not read the last row of the table.
+  std::vector<std::vector<Element>> columns(n + 1);
+  for (size_t i = 0; i < t; ++i) {
+    for (size_t c = 0; c < matrix[i].size(); ++c) {
+      columns[c].resize(t, Element::Zero());
+      columns[c][i] = matrix[i][c];
     }
-    result = std::move(result).Add(blocks[block]);
   }
+  std::vector<std::span<const Element>> blocks(forms.begin(), forms.end());
+  auto values = detail::MulBlocks(blocks, columns);
+
+  std::vector<Element> result;
+  result.reserve(giant_count * t);
+  for (auto& block : values) {
+    block.resize(t, Element::Zero());
+    result.insert(result.end(), block.begin(), block.end());
+  }
+  result.resize(count);
   return result;
 }
 
+/*! @brief Returns the minimal polynomial of a linearly recurrent sequence
+ *  by the Berlekamp-Massey algorithm.
+ *
+ *  The result g is monic and of the least degree L such that
+ *    g_0 s_k + g_1 s_{k+1} + ... + g_L s_{k+L} = 0
+ *  for every k with k + L < sequence.size(). It is determined uniquely when
+ *  the sequence has at least 2L terms.
+ */
+template <concepts::Polynom Poly>
+Poly BerlekampMassey(const std::vector<typename Poly::Element>& sequence) {
+  using Element = typename Poly::Element;
+
+  // Connection polynomials c and its last version before a length change b,
+  //   s_k + c_1 s_{k-1} + ... + c_L s_{k-L} = 0.
+  std::vector<Element> c{Element::One()};
+  std::vector<Element> b{Element::One()};
+  size_t length = 0;
+  size_t shift = 1;
+  Element last_discrepancy = Element::One();
+  for (size_t k = 0; k < sequence.size(); ++k) {
+    Element discrepancy = sequence[k];
+    for (size_t i = 1; i <= length; ++i) {
+      discrepancy += c[i] * sequence[k - i];
+    }
+    if (discrepancy == Element::Zero()) {
+      ++shift;
+      continue;
+    }
+    const Element coef = discrepancy / last_discrepancy;
+    auto previous = c;
+    if (c.size() < b.size() + shift) {
+      c.resize(b.size() + shift, Element::Zero());
+    }
+    for (size_t i = 0; i < b.size(); ++i) {
+      c[i + shift] -= coef * b[i];
+    }
+    if (2 * length <= k) {
+      length = k + 1 - length;
+      c.resize(std::max(c.size(), length + 1), Element::Zero());
+      b = std::move(previous);
+      last_discrepancy = discrepancy;
+      shift = 1;
+    } else {
+      ++shift;
+    }
+  }
+
+  // g(x) = x^L c(1 / x).
+  c.resize(length + 1, Element::Zero());
+  std::reverse(c.begin(), c.end());
+  return Poly(std::move(c));
+}
+
+/*! @brief Computes the minimal polynomial of h modulo f, the monic g of the
+ *  least degree with g(h) = 0 (mod f).
+ *
+ *  For a random linear form the sequence form(h^k) has the same minimal
+ *  polynomial as h with high probability, and its minimal polynomial always
+ *  divides the one of h. The sequences of 2 deg f terms are found by
+ *  PowerProjection and Berlekamp-Massey, their least common multiple is
+ *  accumulated until it annihilates h, which is checked by CompMod.
+ *
+ *  @pre f is monic and deg f >= 1.
+ *  @pre h is already reduced modulo f.
+ */
+template <concepts::Polynom Poly, typename RandomGen>
+Poly MinPolyMod(const Poly& h, const Poly& f, RandomGen& random_gen) {
+  assert(f.Size() >= 2);
+  using Element = typename Poly::Element;
+
+  const size_t n = f.Size() - 1;
+  auto t = static_cast<size_t>(std::sqrt(2.0 * static_cast<double>(n)));
+  if (t == 0) {
+    t = 1;
+  }
+  const auto mod = f.BuildModulus(2 * f.Size());
+  const auto matrix = BuildCompModMatrix(h, t, mod);
+
+  Poly result(Element::One());
+  while (true) {
+    std::vector<Element> form(n);
+    for (auto& value : form) {
+      value = utils::RandomElement<Element>(random_gen);
+    }
+    const auto sequence = PowerProjection(std::move(form), 2 * n, matrix, f);
+    auto candidate = BerlekampMassey<Poly>(sequence);
+    result = result.Mul(candidate.Div(result.Gcd(candidate))).MakeMonic();
+    if (CompMod(result, matrix, mod).IsZero()) {
+      return result;
+    }
+  }
+}
+
+/*! @brief Computes the minimal polynomial of h modulo f with a fixed random
+ *  generator, see MinPolyMod above.
+ */
+template <concepts::Polynom Poly>
+Poly MinPolyMod(const Poly& h, const Poly& f) {
+  std::mt19937_64 random_gen(0);
+  return MinPolyMod(h, f, random_gen);
+}
+
 }  // namespace factorization::polynomial
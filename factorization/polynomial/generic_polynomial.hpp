@@ -23,6 +23,7 @@
 #pragma once
 
 #include <cstddef>
+#include <tuple>
 #include <utility>
 
 #include <factorization/concepts.hpp>
@@ -61,6 +62,7 @@ class GenericPolynomial
   using Base::Div;
   using Base::Mul;
   using Element = Base::Element;
+  using EngineType = Engine;
 
  public:
   [[nodiscard]]
@@ -81,6 +83,23 @@ class GenericPolynomial
     return std::move(*this);
   }
 
+  [[nodiscard]]
+  GenericPolynomial Sqr() const& {
+    if (data_.empty()) {
+      return GenericPolynomial();
+    }
+    return GenericPolynomial(*this).SqrInPlace();
+  }
+
+  [[nodiscard]]
+  GenericPolynomial Sqr() && {
+    if (data_.empty()) {
+      return std::move(*this);
+    }
+    SqrInPlace();
+    return std::move(*this);
+  }
+
   [[nodiscard]]
   GenericPolynomial Div(const GenericPolynomial& rhs) const& {
     if (data_.empty()) {
@@ -198,6 +217,23 @@ class GenericPolynomial
     return BuildModulus(2 * data_.size() - 1);
   }
 
+  // Modulus of this polynomial from the modulus of its product with divisor,
+  // see RebuildModulus of the engines. Engines without it build a new one.
+  [[nodiscard]]
+  Modulus RebuildModulus(const Modulus& modulus,
+                         const GenericPolynomial& divisor,
+                         size_t max_dividend_size) const {
+    if constexpr (requires {
+                    Engine::RebuildModulus(modulus.data_, data_, divisor.data_,
+                                           max_dividend_size);
+                  }) {
+      return Modulus(Engine::RebuildModulus(modulus.data_, data_,
+                                            divisor.data_, max_dividend_size));
+    } else {
+      return BuildModulus(max_dividend_size);
+    }
+  }
+
   [[nodiscard]]
   GenericPolynomial Gcd(GenericPolynomial b) const& {
     return GenericPolynomial(*this).Gcd(std::move(b)).MakeMonic();
@@ -209,6 +245,21 @@ class GenericPolynomial
     return GenericPolynomial(std::move(gcd)).MakeMonic();
   }
 
+  // <gcd, s, t> with s * (*this) + t * b = gcd, gcd is monic
+  [[nodiscard]]
+  std::tuple<GenericPolynomial, GenericPolynomial, GenericPolynomial> XGcd(
+      const GenericPolynomial& b) const {
+    auto [gcd, s, t] = Engine::XGcd(data_, b.data_);
+    return {GenericPolynomial(std::move(gcd)), GenericPolynomial(std::move(s)),
+            GenericPolynomial(std::move(t))};
+  }
+
+  // Returns zero if *this is not invertible modulo mod
+  [[nodiscard]]
+  GenericPolynomial InvMod(const GenericPolynomial& mod) const {
+    return GenericPolynomial(Engine::InvMod(data_, mod.data_));
+  }
+
  protected:
   using Base::data_;
   using Base::DivInPlace;
@@ -222,6 +273,15 @@ class GenericPolynomial
     return *this;
   }
 
+  GenericPolynomial& SqrInPlace() {
+    if (data_.size() == 1) {
+      data_[0] *= data_[0];
+      return *this;
+    }
+    data_ = Engine::Sqr(data_);
+    return *this;
+  }
+
   GenericPolynomial& DivInPlace(const GenericPolynomial& rhs) {
     const size_t n = data_.size();
     const size_t m = rhs.data_.size();
@@ -0,0 +1,514 @@
+// SPDX-License-Identifier: LGPL-2.1-or-later
+//
+// Modifications Copyright (c) 2026 Andrei Ishutin
+//
+// Portions of the Half-GCD/GCD implementation are adapted from NTL's ZZ_pEX
+// implementation. NTL is written and maintained by Victor Shoup and distributed
+// under the GNU Lesser General Public License version 2.1 or later:
+//   https://libntl.org
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <limits>
+#include <span>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <factorization/concepts.hpp>
+
+namespace factorization::polynomial {
+
+/*! @brief Half-GCD over any polynomial engine.
+ *
+ *  The routines follow the structure of NTL's ZZ_pEX HalfGCD/GCD
+ *  implementation, adapted to this polynomial representation. Products and
+ *  divisions go through Engine::Mul, Engine::DivRem and Engine::Rem, so the
+ *  asymptotics follow the engine multiplication.
+ *
+ *  Polynomials shorter than kGcdThreshold are handled by the Euclidean
+ *  algorithm. Inside Half-GCD, reduction steps of at most kThreshold degrees
+ *  are done by plain division steps.
+ */
+template <concepts::GaloisFieldElement Elem, typename Engine,
+          size_t kThreshold, size_t kGcdThreshold = kThreshold>
+struct HalfGcd {
+  struct Matrix {
+    std::vector<Elem> data[2][2];
+  };
+
+  // Matrix products whose operands are all at least this long use seven
+  // multiplications instead of eight, see MulMatrix.
+  constexpr static size_t kStrassenThreshold = 64;
+
+  // Engines which multiply whole polynomial matrices sharing the transforms
+  // of the entries, see NttEngine::MulMatrix. For them the products above
+  // kStrassenThreshold go to Engine::MulMatrix instead.
+  constexpr static bool kBatchedMatrix =
+      requires(std::span<const std::vector<Elem>* const> entries) {
+        Engine::MulMatrix(entries, entries, size_t{1});
+      };
+
+  [[nodiscard]]
+  static std::vector<Elem> Gcd(std::vector<Elem> a, std::vector<Elem> b) {
+    if (a.size() == b.size()) {
+      if (a.empty()) {
+        return {};
+      }
+      b = Engine::Rem(std::move(b), a);
+    } else if (a.size() < b.size()) {
+      a.swap(b);
+    }
+
+    Workspace workspace;
+    while (a.size() >= kGcdThreshold && !b.empty()) {
+      HalfGCDReduce(a, b, workspace);
+      if (!b.empty()) {
+        a = Engine::Rem(std::move(a), b);
+        a.swap(b);
+      }
+    }
+    return PlainGCD(std::move(a), std::move(b));
+  }
+
+  /*! @brief Returns <g, s, t> such that s a + t b = g, where g = gcd(a, b)
+   *  is monic.
+   *
+   *  After the first division step, if any, a single Half-GCD with
+   *  d_red = u.size() reduces (u, v) to (g', 0). Its matrix maps (u, v) to
+   *  (g', 0), so the cofactors are read from the first row.
+   */
+  [[nodiscard]]
+  static std::tuple<std::vector<Elem>, std::vector<Elem>, std::vector<Elem>>
+  XGcd(std::vector<Elem> a, std::vector<Elem> b) {
+    if (a.empty() && b.empty()) {
+      return {};
+    }
+
+    // a = quotient * b + v if both have the same size
+    std::vector<Elem> quotient;
+    const bool divided = a.size() == b.size();
+    const bool swapped = a.size() < b.size();
+    std::vector<Elem> u;
+    std::vector<Elem> v;
+    if (divided) {
+      auto [q, r] = Engine::DivRem(std::move(a), b);
+      quotient = std::move(q);
+      u = std::move(b);
+      v = std::move(r);
+    } else if (swapped) {
+      u = std::move(b);
+      v = std::move(a);
+    } else {
+      u = std::move(a);
+      v = std::move(b);
+    }
+
+    Workspace workspace;
+    Matrix m;
+    HalfGCD(m, u, v, u.size(), workspace);
+    auto g = AddProducts(m.data[0][0], u, m.data[0][1], v);
+
+    std::vector<Elem> s;
+    std::vector<Elem> t;
+    if (divided) {
+      // g = m00 b + m01 (a - quotient b)
+      s = std::move(m.data[0][1]);
+      t = Sub(std::move(m.data[0][0]), MulTerm(s, quotient));
+    } else if (swapped) {
+      s = std::move(m.data[0][1]);
+      t = std::move(m.data[0][0]);
+    } else {
+      s = std::move(m.data[0][0]);
+      t = std::move(m.data[0][1]);
+    }
+
+    const Elem inverse = g.back().Inverse();
+    for (auto* value : {&g, &s, &t}) {
+      for (auto& coeff : *value) {
+        coeff *= inverse;
+      }
+    }
+    return {std::move(g), std::move(s), std::move(t)};
+  }
+
+  /*! @brief Returns the inverse of a modulo f, or zero if gcd(a, f) != 1.
+   *
+   *  @pre f is nonzero.
+   */
+  [[nodiscard]]
+  static std::vector<Elem> InvMod(std::vector<Elem> a,
+                                  const std::vector<Elem>& f) {
+    if (a.size() >= f.size()) {
+      a = Engine::Rem(std::move(a), f);
+    }
+    auto [g, s, t] = XGcd(std::move(a), f);
+    if (g.size() != 1) {
+      return {};
+    }
+    return s;
+  }
+
+ private:
+  // Buffers for the sums in MulMatrix, shared by all levels of a single
+  // Gcd or XGcd call. They keep their capacity between matrix products.
+  struct Workspace {
+    std::vector<Elem> lhs_sums[4];
+    std::vector<Elem> rhs_sums[4];
+  };
+
+  [[nodiscard]]
+  static std::vector<Elem> PlainGCD(std::vector<Elem> a, std::vector<Elem> b) {
+    if (a.size() < b.size()) {
+      a.swap(b);
+    }
+    while (!b.empty()) {
+      a = Engine::Rem(std::move(a), b);
+      a.swap(b);
+    }
+    return a;
+  }
+
+  static void TrimInPlace(std::vector<Elem>& a) {
+    while (!a.empty() && a.back() == Elem::Zero()) {
+      a.pop_back();
+    }
+  }
+
+  [[nodiscard]]
+  static std::vector<Elem> Trim(std::vector<Elem> a) {
+    TrimInPlace(a);
+    return a;
+  }
+
+  [[nodiscard]]
+  static std::vector<Elem> Sub(std::vector<Elem> a,
+                               const std::vector<Elem>& b) {
+    if (a.size() < b.size()) {
+      a.resize(b.size(), Elem::Zero());
+    }
+    for (size_t i = 0; i < b.size(); ++i) {
+      a[i] -= b[i];
+    }
+    return Trim(std::move(a));
+  }
+
+  [[nodiscard]]
+  static std::vector<Elem> Add(std::vector<Elem> a,
+                               const std::vector<Elem>& b) {
+    if (a.size() < b.size()) {
+      a.resize(b.size(), Elem::Zero());
+    }
+    for (size_t i = 0; i < b.size(); ++i) {
+      a[i] += b[i];
+    }
+    return Trim(std::move(a));
+  }
+
+  static void HalfGCDReduce(std::vector<Elem>& u, std::vector<Elem>& v,
+                            Workspace& workspace) {
+    const size_t d_red = u.size() / 2;
+    if (v.empty() || v.size() <= u.size() - d_red) {
+      return;
+    }
+
+    const size_t du = u.size() - 1;
+    size_t d1 = (d_red + 1) / 2;
+    d1 = std::max<size_t>(d1, 1);
+    if (d1 >= d_red) {
+      d1 = d_red - 1;
+    }
+
+    Matrix m1;
+    HalfGCD(m1, u, v, d1, workspace);
+    ApplyMatrix(u, v, m1);
+
+    const long d2 =
+        Degree(v) - static_cast<long>(du) + static_cast<long>(d_red);
+    if (v.empty() || d2 <= 0) {
+      return;
+    }
+
+    auto [quotient, remainder] = Engine::DivRem(u, v);
+    u = std::move(remainder);
+    u.swap(v);
+
+    HalfGCD(m1, u, v, static_cast<size_t>(d2), workspace);
+    ApplyMatrix(u, v, m1);
+  }
+
+  static void HalfGCD(Matrix& result, const std::vector<Elem>& u,
+                      const std::vector<Elem>& v, size_t d_red,
+                      Workspace& workspace) {
+    if (v.empty() || v.size() <= u.size() - d_red) {
+      SetIdentity(result);
+      return;
+    }
+
+    const long shift =
+        std::max<long>(Degree(u) - 2 * static_cast<long>(d_red) + 2, 0);
+    auto u1 = RightShift(u, static_cast<size_t>(shift));
+    auto v1 = RightShift(v, static_cast<size_t>(shift));
+
+    if (d_red <= kThreshold) {
+      IterHalfGCD(result, u1, v1, d_red);
+      return;
+    }
+
+    size_t d1 = (d_red + 1) / 2;
+    d1 = std::max<size_t>(d1, 1);
+    if (d1 >= d_red) {
+      d1 = d_red - 1;
+    }
+
+    Matrix m1;
+    HalfGCD(m1, u1, v1, d1, workspace);
+    ApplyMatrix(u1, v1, m1);
+
+    const long d2 = Degree(v1) - Degree(u) + shift + static_cast<long>(d_red);
+    if (v1.empty() || d2 <= 0) {
+      result = std::move(m1);
+      return;
+    }
+
+    auto [quotient, remainder] = Engine::DivRem(u1, v1);
+    u1 = std::move(remainder);
+    u1.swap(v1);
+
+    Matrix m2;
+    HalfGCD(m2, u1, v1, static_cast<size_t>(d2), workspace);
+    // The remainders are not needed anymore, release them before the products
+    u1 = {};
+    v1 = {};
+    UpdateAfterDivision(m1, quotient);
+    MulMatrix(m2, m1, result, workspace);
+  }
+
+  static void IterHalfGCD(Matrix& result, std::vector<Elem>& u,
+                          std::vector<Elem>& v, size_t d_red) {
+    SetIdentity(result);
+    const size_t goal_size = u.size() - d_red;
+    if (v.size() <= goal_size) {
+      return;
+    }
+
+    while (v.size() > goal_size) {
+      auto [quotient, remainder] = Engine::DivRem(u, v);
+      u = std::move(remainder);
+      u.swap(v);
+      UpdateAfterDivision(result, quotient);
+    }
+  }
+
+  static void SetIdentity(Matrix& matrix) {
+    matrix.data[0][0] = {Elem::One()};
+    matrix.data[0][1] = {};
+    matrix.data[1][0] = {};
+    matrix.data[1][1] = {Elem::One()};
+  }
+
+  static void ApplyMatrix(std::vector<Elem>& u, std::vector<Elem>& v,
+                          const Matrix& matrix) {
+    if constexpr (kBatchedMatrix) {
+      const auto& [m11, m12] = matrix.data[0];
+      const auto& [m21, m22] = matrix.data[1];
+      if (std::min({m11.size(), m12.size(), m21.size(), m22.size()}) >=
+          kStrassenThreshold) {
+        const std::array<const std::vector<Elem>*, 4> lhs{&m11, &m12, &m21,
+                                                          &m22};
+        const std::array<const std::vector<Elem>*, 2> rhs{&u, &v};
+        auto product = Engine::MulMatrix(lhs, rhs, 2);
+        u = std::move(product[0]);
+        v = std::move(product[1]);
+        return;
+      }
+    }
+    auto new_u = AddProducts(matrix.data[0][0], u, matrix.data[0][1], v);
+    auto new_v = AddProducts(matrix.data[1][0], u, matrix.data[1][1], v);
+    u = std::move(new_u);
+    v = std::move(new_v);
+  }
+
+  // Writes lhs * rhs into result, which must not alias the operands.
+  // Large products use the Strassen-Winograd scheme: seven multiplications
+  // and fifteen additions, the sums are kept in the workspace buffers.
+  // Engines with batched matrix products do better by reusing transforms.
+  static void MulMatrix(const Matrix& lhs, const Matrix& rhs, Matrix& result,
+                        Workspace& workspace) {
+    const auto& [a11, a12] = lhs.data[0];
+    const auto& [a21, a22] = lhs.data[1];
+    const auto& [b11, b12] = rhs.data[0];
+    const auto& [b21, b22] = rhs.data[1];
+
+    size_t min_size = std::numeric_limits<size_t>::max();
+    for (const auto* entry : {&a11, &a12, &a21, &a22, &b11, &b12, &b21, &b22}) {
+      min_size = std::min(min_size, entry->size());
+    }
+    if (min_size < kStrassenThreshold) {
+      result.data[0][0] = AddProducts(a11, b11, a12, b21);
+      result.data[0][1] = AddProducts(a11, b12, a12, b22);
+      result.data[1][0] = AddProducts(a21, b11, a22, b21);
+      result.data[1][1] = AddProducts(a21, b12, a22, b22);
+      return;
+    }
+    if constexpr (kBatchedMatrix) {
+      const std::array<const std::vector<Elem>*, 4> lhs_entries{&a11, &a12,
+                                                                &a21, &a22};
+      const std::array<const std::vector<Elem>*, 4> rhs_entries{&b11, &b12,
+                                                                &b21, &b22};
+      auto product = Engine::MulMatrix(lhs_entries, rhs_entries, 2);
+      for (size_t i = 0; i < 4; ++i) {
+        result.data[i / 2][i % 2] = std::move(product[i]);
+      }
+      return;
+    }
+
+    auto& [s1, s2, s3, s4] = workspace.lhs_sums;
+    auto& [t1, t2, t3, t4] = workspace.rhs_sums;
+    AssignAdd(s1, a21, a22);
+    AssignSub(s2, s1, a11);
+    AssignSub(s3, a11, a21);
+    AssignSub(s4, a12, s2);
+    AssignSub(t1, b12, b11);
+    AssignSub(t2, b22, t1);
+    AssignSub(t3, b22, b12);
+    AssignSub(t4, t2, b21);
+
+    auto m1 = MulTerm(a11, b11);
+    auto u2 = Add(MulTerm(s2, t2), m1);
+    result.data[0][0] = Add(std::move(m1), MulTerm(a12, b21));
+    auto u3 = Add(MulTerm(s3, t3), u2);
+    auto m5 = MulTerm(s1, t1);
+    result.data[0][1] = Add(Add(std::move(u2), m5), MulTerm(s4, b22));
+    result.data[1][0] = Sub(u3, MulTerm(a22, t4));
+    result.data[1][1] = Add(std::move(u3), std::move(m5));
+  }
+
+  // Sets out to lhs + rhs reusing its storage.
+  static void AssignAdd(std::vector<Elem>& out, const std::vector<Elem>& lhs,
+                        const std::vector<Elem>& rhs) {
+    out.assign(lhs.begin(), lhs.end());
+    if (out.size() < rhs.size()) {
+      out.resize(rhs.size(), Elem::Zero());
+    }
+    for (size_t i = 0; i < rhs.size(); ++i) {
+      out[i] += rhs[i];
+    }
+    TrimInPlace(out);
+  }
+
+  // Sets out to lhs - rhs reusing its storage.
+  static void AssignSub(std::vector<Elem>& out, const std::vector<Elem>& lhs,
+                        const std::vector<Elem>& rhs) {
+    out.assign(lhs.begin(), lhs.end());
+    if (out.size() < rhs.size()) {
+      out.resize(rhs.size(), Elem::Zero());
+    }
+    for (size_t i = 0; i < rhs.size(); ++i) {
+      out[i] -= rhs[i];
+    }
+    TrimInPlace(out);
+  }
+
+  [[nodiscard]]
+  static std::vector<Elem> MulTerm(const std::vector<Elem>& lhs,
+                                   const std::vector<Elem>& rhs) {
+    if (lhs.empty() || rhs.empty()) {
+      return {};
+    }
+    if (lhs.size() == 1 && lhs[0] == Elem::One()) {
+      return rhs;
+    }
+    if (rhs.size() == 1 && rhs[0] == Elem::One()) {
+      return lhs;
+    }
+    return Engine::Mul(lhs, rhs);
+  }
+
+  [[nodiscard]]
+  static std::vector<Elem> AddProducts(const std::vector<Elem>& a,
+                                       const std::vector<Elem>& b,
+                                       const std::vector<Elem>& c,
+                                       const std::vector<Elem>& d) {
+    auto first = MulTerm(a, b);
+    if (first.empty()) {
+      return MulTerm(c, d);
+    }
+    return Add(std::move(first), MulTerm(c, d));
+  }
+
+  static void UpdateAfterDivision(Matrix& matrix,
+                                  const std::vector<Elem>& quotient) {
+    auto top_left = std::move(matrix.data[1][0]);
+    auto bottom_left =
+        Sub(std::move(matrix.data[0][0]), MulByQuotient(quotient, top_left));
+    matrix.data[0][0] = std::move(top_left);
+    matrix.data[1][0] = std::move(bottom_left);
+
+    auto top_right = std::move(matrix.data[1][1]);
+    auto bottom_right =
+        Sub(std::move(matrix.data[0][1]), MulByQuotient(quotient, top_right));
+    matrix.data[0][1] = std::move(top_right);
+    matrix.data[1][1] = std::move(bottom_right);
+  }
+
+  [[nodiscard]]
+  static std::vector<Elem> MulByQuotient(const std::vector<Elem>& quotient,
+                                         const std::vector<Elem>& value) {
+    if (quotient.size() > 4) {
+      return MulTerm(quotient, value);
+    }
+    if (quotient.empty() || value.empty()) {
+      return {};
+    }
+    if (quotient.size() == 1) {
+      if (quotient[0] == Elem::Zero()) {
+        return {};
+      }
+      if (quotient[0] == Elem::One()) {
+        return value;
+      }
+      std::vector<Elem> result(value);
+      for (auto& coeff : result) {
+        coeff *= quotient[0];
+      }
+      return Trim(std::move(result));
+    }
+
+    std::vector<Elem> result(value.size() + quotient.size() - 1, Elem::Zero());
+    for (size_t i = 0; i < quotient.size(); ++i) {
+      if (quotient[i] == Elem::Zero()) [[unlikely]] {
+        continue;
+      }
+      for (size_t j = 0; j < value.size(); ++j) {
+        if (value[j] == Elem::Zero()) [[unlikely]] {
+          continue;
+        }
+        result[i + j] += quotient[i] * value[j];
+      }
+    }
+    return Trim(std::move(result));
+  }
+
+  [[nodiscard]]
+  static std::vector<Elem> RightShift(const std::vector<Elem>& a,
+                                      size_t shift) {
+    if (shift >= a.size()) {
+      return {};
+    }
+    return Trim(std::vector<Elem>(a.begin() + shift, a.end()));
+  }
+
+  [[nodiscard]]
+  static long Degree(const std::vector<Elem>& a) {
+    if (a.empty()) {
+      return -1;
+    }
+    return static_cast<long>(a.size() - 1);
+  }
+};
+
+}  // namespace factorization::polynomial
@@ -0,0 +1,440 @@
+// MIT License
+//
+// Copyright (c) 2026 Andrei Ishutin
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <factorization/concepts.hpp>
+
+#include "half_gcd.hpp"
+#include "karatsuba_engine.hpp"
+#include "ntt_engine.hpp"
+#include "tuning.hpp"
+
+namespace factorization::polynomial {
+
+/*! @brief Engine choosing the algorithm of every operation at runtime.
+ *
+ *  Small operands go to schoolbook and Karatsuba methods, large ones to NTT
+ *  for prime fields and to NTT of Kronecker substituted operands for
+ *  extension fields, see Thresholds. NTT is used only while its products are
+ *  exact for the field, see NttEngine::IsExact.
+ */
+template <concepts::GaloisFieldElement Elem,
+          Thresholds kThresholds = DefaultThresholds<Elem>()>
+struct HybridEngine {
+ private:
+  constexpr static bool kPrimeField = Elem::FieldPower() == 1;
+
+  using Karatsuba = KaratsubaEngine<Elem, kThresholds.karatsuba,
+                                    kThresholds.plain_division>;
+  // NttEngine accepts prime fields only, for other fields this alias is
+  // never used for computations.
+  using Ntt = std::conditional_t<
+      kPrimeField, NttEngine<Elem, kThresholds.plain_division>, Karatsuba>;
+
+ public:
+  // Only the precomputations of the chosen engine are built.
+  struct Modulus {
+    std::vector<Elem> polynomial;
+    typename Karatsuba::Modulus karatsuba;
+    typename Ntt::Modulus ntt;
+    bool use_ntt = false;
+  };
+
+  // Splits large transforms of NTT and Kronecker products between the
+  // workers of scheduler, see IntegerNtt::SetScheduler. min_size is the
+  // transform size, Karatsuba products keep the defaults of
+  // KaratsubaEngine::SetScheduler.
+  static void SetScheduler(runtime::IScheduler* scheduler,
+                           size_t min_size = Convolve::kParallelMinSize) {
+    Convolve::SetScheduler(scheduler, min_size);
+    Karatsuba::SetScheduler(scheduler);
+  }
+
+  [[nodiscard]]
+  static std::vector<Elem> Mul(std::span<const Elem> a,
+                               std::span<const Elem> b) {
+    if (a.empty() || b.empty()) {
+      return {};
+    }
+    const size_t min_size = std::min(a.size(), b.size());
+    if constexpr (kPrimeField) {
+      if (min_size >= kThresholds.ntt && Ntt::IsExact(min_size)) {
+        return Ntt::Mul(a, b);
+      }
+    } else {
+      if (min_size >= kThresholds.kronecker && IsKroneckerExact(min_size)) {
+        return Trim(Unpack(Convolve::Convolve(Pack(a), Pack(b),
+                                              PackedProductSize(a, b))));
+      }
+    }
+    return Karatsuba::Mul(a, b);
+  }
+
+  [[nodiscard]]
+  static std::vector<Elem> Sqr(std::span<const Elem> a) {
+    if (a.empty()) {
+      return {};
+    }
+    if constexpr (kPrimeField) {
+      if (a.size() >= kThresholds.ntt && Ntt::IsExact(a.size())) {
+        return Ntt::Sqr(a);
+      }
+    } else {
+      if (a.size() >= kThresholds.kronecker && IsKroneckerExact(a.size())) {
+        return Trim(
+            Unpack(Convolve::Square(Pack(a), PackedProductSize(a, a))));
+      }
+    }
+    return Karatsuba::Sqr(a);
+  }
+
+  /*! @brief Estimated number of field multiplications in a product of two
+   *  polynomials of the given size, see KaratsubaEngine::ProductCost.
+   *
+   *  Kronecker products of extension fields are costed as Karatsuba ones.
+   */
+  [[nodiscard]]
+  static double ProductCost(size_t size) {
+    if constexpr (kPrimeField) {
+      if (size >= kThresholds.ntt && Ntt::IsExact(size)) {
+        return Ntt::ProductCost(size);
+      }
+    }
+    return Karatsuba::ProductCost(size);
+  }
+
+  [[nodiscard]]
+  static std::vector<Elem> MulMiddle(const std::vector<Elem>& a,
+                                     const std::vector<Elem>& b, size_t from,
+                                     size_t to) {
+    if constexpr (kPrimeField) {
+      const size_t min_size = std::min({a.size(), b.size(), to});
+      if (min_size >= kThresholds.ntt && Ntt::IsExact(min_size)) {
+        return Ntt::MulMiddle(a, b, from, to);
+      }
+    }
+    return Karatsuba::MulMiddle(a, b, from, to);
+  }
+
+  // The batch goes to NTT only if every product would.
+  [[nodiscard]]
+  static std::vector<std::vector<Elem>> MulMany(
+      const std::vector<Elem>& a, std::span<const std::vector<Elem>> others) {
+    if constexpr (kPrimeField) {
+      size_t min_size = a.size();
+      size_t max_size = a.size();
+      for (const auto& other : others) {
+        min_size = std::min(min_size, other.size());
+        max_size = std::max(max_size, other.size());
+      }
+      if (min_size >= kThresholds.ntt && Ntt::IsExact(max_size)) {
+        return Ntt::MulMany(a, others);
+      }
+    }
+    std::vector<std::vector<Elem>> result;
+    result.reserve(others.size());
+    for (const auto& other : others) {
+      result.push_back(Mul(a, other));
+    }
+    return result;
+  }
+
+  // See NttEngine::MulMatrix. Every coefficient of the result is a sum of
+  // inner products, which is accounted for by the exactness check. Small
+  // entries are multiplied one product at a time.
+  [[nodiscard]]
+  static std::vector<std::vector<Elem>> MulMatrix(
+      std::span<const std::vector<Elem>* const> lhs,
+      std::span<const std::vector<Elem>* const> rhs, size_t inner)
+    requires kPrimeField
+  {
+    size_t min_size = std::numeric_limits<size_t>::max();
+    size_t max_size = 0;
+    for (const auto& entries : {lhs, rhs}) {
+      for (const auto* entry : entries) {
+        min_size = std::min(min_size, entry->size());
+        max_size = std::max(max_size, entry->size());
+      }
+    }
+    if (min_size >= kThresholds.ntt && Ntt::IsExact(inner * max_size)) {
+      return Ntt::MulMatrix(lhs, rhs, inner);
+    }
+
+    const size_t rows = lhs.size() / inner;
+    const size_t columns = rhs.size() / inner;
+    std::vector<std::vector<Elem>> result(rows * columns);
+    for (size_t i = 0; i < rows; ++i) {
+      for (size_t k = 0; k < columns; ++k) {
+        auto& sum = result[i * columns + k];
+        for (size_t j = 0; j < inner; ++j) {
+          const auto product = Mul(*lhs[i * inner + j], *rhs[j * columns + k]);
+          if (sum.size() < product.size()) {
+            sum.resize(product.size(), Elem::Zero());
+          }
+          for (size_t t = 0; t < product.size(); ++t) {
+            sum[t] += product[t];
+          }
+        }
+        TrimInPlace(sum);
+      }
+    }
+    return result;
+  }
+
+  // assume a.size() >= b.size()
+  [[nodiscard]]
+  static std::vector<Elem> Rem(std::vector<Elem> a,
+                               const std::vector<Elem>& b) {
+    if (UseNttDivision(a.size(), b.size())) {
+      return Ntt::Rem(std::move(a), b);
+    }
+    return Karatsuba::Rem(std::move(a), b);
+  }
+
+  [[nodiscard]]
+  static std::vector<Elem> Rem(std::vector<Elem> a, const Modulus& modulus) {
+    if (modulus.use_ntt) {
+      return Ntt::Rem(std::move(a), modulus.ntt);
+    }
+    return Karatsuba::Rem(std::move(a), modulus.karatsuba);
+  }
+
+  // assume a.size() >= b.size()
+  [[nodiscard]]
+  static std::vector<Elem> Div(const std::vector<Elem>& a,
+                               const std::vector<Elem>& b) {
+    if (UseNttDivision(a.size(), b.size())) {
+      return Ntt::Div(a, b);
+    }
+    return Karatsuba::Div(a, b);
+  }
+
+  [[nodiscard]]
+  static std::vector<Elem> Div(const std::vector<Elem>& a,
+                               const Modulus& modulus) {
+    if (modulus.use_ntt) {
+      return Ntt::Div(a, modulus.ntt);
+    }
+    return Karatsuba::Div(a, modulus.karatsuba);
+  }
+
+  [[nodiscard]]
+  static std::pair<std::vector<Elem>, std::vector<Elem>> DivRem(
+      std::vector<Elem> a, const std::vector<Elem>& b) {
+    if (UseNttDivision(a.size(), b.size())) {
+      return Ntt::DivRem(std::move(a), b);
+    }
+    return Karatsuba::DivRem(std::move(a), b);
+  }
+
+  [[nodiscard]]
+  static std::pair<std::vector<Elem>, std::vector<Elem>> DivRem(
+      std::vector<Elem> a, const Modulus& modulus) {
+    if (modulus.use_ntt) {
+      return Ntt::DivRem(std::move(a), modulus.ntt);
+    }
+    return Karatsuba::DivRem(std::move(a), modulus.karatsuba);
+  }
+
+  [[nodiscard]]
+  static Modulus BuildModulus(const std::vector<Elem>& polynomial,
+                              size_t max_dividend_size) {
+    Modulus result;
+    result.polynomial = polynomial;
+    result.use_ntt = UseNttDivision(max_dividend_size, polynomial.size());
+    if (result.use_ntt) {
+      result.ntt = Ntt::BuildModulus(polynomial, max_dividend_size);
+    } else {
+      result.karatsuba = Karatsuba::BuildModulus(polynomial, max_dividend_size);
+    }
+    return result;
+  }
+
+  // Modulus of polynomial, which is modulus.polynomial divided by divisor,
+  // reusing the precomputations of the old modulus if the same engine
+  // divides by both.
+  [[nodiscard]]
+  static Modulus RebuildModulus(const Modulus& modulus,
+                                const std::vector<Elem>& polynomial,
+                                const std::vector<Elem>& divisor,
+                                size_t max_dividend_size) {
+    Modulus result;
+    result.polynomial = polynomial;
+    result.use_ntt = UseNttDivision(max_dividend_size, polynomial.size());
+    if (result.use_ntt != modulus.use_ntt) {
+      return BuildModulus(polynomial, max_dividend_size);
+    }
+    if (result.use_ntt) {
+      result.ntt = Ntt::RebuildModulus(modulus.ntt, polynomial, divisor,
+                                       max_dividend_size);
+    } else {
+      result.karatsuba = Karatsuba::RebuildModulus(
+          modulus.karatsuba, polynomial, divisor, max_dividend_size);
+    }
+    return result;
+  }
+
+  [[nodiscard]]
+  static std::vector<Elem> Gcd(std::vector<Elem> a, std::vector<Elem> b) {
+    return HalfGcdImpl::Gcd(std::move(a), std::move(b));
+  }
+
+  [[nodiscard]]
+  static std::tuple<std::vector<Elem>, std::vector<Elem>, std::vector<Elem>>
+  XGcd(std::vector<Elem> a, std::vector<Elem> b) {
+    return HalfGcdImpl::XGcd(std::move(a), std::move(b));
+  }
+
+  [[nodiscard]]
+  static std::vector<Elem> InvMod(std::vector<Elem> a,
+                                  const std::vector<Elem>& f) {
+    return HalfGcdImpl::InvMod(std::move(a), f);
+  }
+
+ private:
+  using HalfGcdImpl = HalfGcd<Elem, HybridEngine, kThresholds.half_gcd,
+                              kThresholds.half_gcd_min>;
+  using Convolve = detail::IntegerNtt<detail::kNttMod, detail::kNttGenerator>;
+
+  // Every element of GF(p^k) is a polynomial of degree less than k in the
+  // field generator y. Its coefficients take a slot of 2k - 1 integers, so
+  // products of two elements do not overlap with the neighbouring slots.
+  constexpr static size_t kFieldPower = Elem::FieldPower();
+  constexpr static size_t kSlotSize = 2 * kFieldPower - 1;
+
+  static void TrimInPlace(std::vector<Elem>& a) {
+    while (!a.empty() && a.back() == Elem::Zero()) {
+      a.pop_back();
+    }
+  }
+
+  [[nodiscard]]
+  static std::vector<Elem> Trim(std::vector<Elem> a) {
+    TrimInPlace(a);
+    return a;
+  }
+
+  [[nodiscard]]
+  static bool UseNttDivision(size_t dividend_size, size_t divisor_size) {
+    if constexpr (kPrimeField) {
+      return divisor_size >= kThresholds.ntt_division &&
+             dividend_size + 1 >= divisor_size + kThresholds.ntt_division &&
+             Ntt::IsExact(dividend_size);
+    }
+    return false;
+  }
+
+  // Every coefficient of the packed product is a sum of at most
+  // size * k products of values below p.
+  [[nodiscard]]
+  static bool IsKroneckerExact(size_t size) {
+    const auto p = static_cast<__uint128_t>(Elem::FieldBase());
+    return (p - 1) * (p - 1) <= (detail::kNttMod - 1) / (size * kFieldPower);
+  }
+
+  [[nodiscard]]
+  static size_t PackedProductSize(std::span<const Elem> a,
+                                  std::span<const Elem> b) {
+    return (a.size() + b.size() - 2) * kSlotSize + kSlotSize;
+  }
+
+  // Substitutes y = x^(2k - 1): a sum of a_ij y^j x^i becomes a polynomial
+  // over integers with coefficients a_ij at (2k - 1)i + j.
+  [[nodiscard]]
+  static std::vector<uint64_t> Pack(std::span<const Elem> a) {
+    std::vector<uint64_t> result((a.size() - 1) * kSlotSize + kFieldPower);
+    for (size_t i = 0; i < a.size(); ++i) {
+      const auto coefficients = a[i].Get();
+      for (size_t j = 0; j < kFieldPower; ++j) {
+        result[i * kSlotSize + j] = static_cast<uint64_t>(coefficients[j]);
+      }
+    }
+    return result;
+  }
+
+  // Reduces every slot of a packed product to an element. Powers y^j with
+  // j >= k are replaced by their representation in the field. The sums are
+  // below k * p^2, which does not overflow as long as IsKroneckerExact holds.
+  [[nodiscard]]
+  static std::vector<Elem> Unpack(const std::vector<uint64_t>& values) {
+    static const auto high_powers = HighPowers();
+    const uint64_t p = Elem::FieldBase();
+
+    std::vector<Elem> result(values.size() / kSlotSize);
+    std::array<uint64_t, kFieldPower> sum;
+    std::array<typename Elem::Coefficient, kFieldPower> coefficients;
+    for (size_t i = 0; i < result.size(); ++i) {
+      const uint64_t* slot = values.data() + i * kSlotSize;
+      for (size_t j = 0; j < kFieldPower; ++j) {
+        sum[j] = slot[j] % p;
+      }
+      for (size_t j = kFieldPower; j < kSlotSize; ++j) {
+        const uint64_t value = slot[j] % p;
+        if (value == 0) {
+          continue;
+        }
+        for (size_t t = 0; t < kFieldPower; ++t) {
+          sum[t] += value * high_powers[j - kFieldPower][t];
+        }
+      }
+      for (size_t j = 0; j < kFieldPower; ++j) {
+        coefficients[j] = static_cast<typename Elem::Coefficient>(sum[j] % p);
+      }
+      result[i] = Elem(coefficients);
+    }
+    return result;
+  }
+
+  // Coefficients of y^j for j in [k, 2k - 1).
+  [[nodiscard]]
+  static std::vector<std::array<uint64_t, kFieldPower>> HighPowers() {
+    std::array<typename Elem::Coefficient, kFieldPower> top{};
+    top[kFieldPower - 1] = 1;
+    const Elem y_top(top);
+
+    std::vector<std::array<uint64_t, kFieldPower>> result;
+    for (size_t j = kFieldPower; j < kSlotSize; ++j) {
+      std::array<typename Elem::Coefficient, kFieldPower> other{};
+      other[j - kFieldPower + 1] = 1;
+      const auto coefficients = (y_top * Elem(other)).Get();
+      auto& power = result.emplace_back();
+      for (size_t t = 0; t < kFieldPower; ++t) {
+        power[t] = static_cast<uint64_t>(coefficients[t]);
+      }
+    }
+    return result;
+  }
+};
+
+}  // namespace factorization::polynomial
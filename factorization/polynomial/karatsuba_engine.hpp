@@ -25,33 +25,172 @@
 #include <algorithm>
 #include <cstddef>
 #include <span>
+#include <tuple>
 #include <utility>
 #include <vector>
 
 #include <factorization/concepts.hpp>
+#include <factorization/runtime/parallel_for.hpp>
+
+#include "half_gcd.hpp"
+#include "sparse_modulus.hpp"
 
 namespace factorization::polynomial {
 
-template <concepts::GaloisFieldElement Elem>
+// Products with an operand of at most kKaratsubaThreshold coefficients are
+// computed by the schoolbook method, so are divisions with a divisor or a
+// quotient of at most kPlainDivThreshold coefficients.
+template <concepts::GaloisFieldElement Elem, size_t kKaratsubaThreshold = 128,
+          size_t kPlainDivThreshold = 128>
 struct KaratsubaEngine {
+  static_assert(kKaratsubaThreshold >= 1);
+
+  // Gcd runs the Euclidean algorithm below kHalfGCDMinSize. Half-GCD does
+  // reduction steps of at most kHalfGCDThreshold degrees by plain division,
+  // see HalfGcd. Its Karatsuba products overtake the quadratic Euclidean
+  // algorithm only at tens of thousands of coefficients: at about 16000 for
+  // GF(2^3) and between 32000 and 64000 for GF(2^8), Z_17 and Z_1000003.
+  constexpr static size_t kHalfGCDThreshold = 128;
+  constexpr static size_t kHalfGCDMinSize = 32768;
+
+  // The inverse is empty if the plain division is always used. Sparse
+  // moduli skip it as well, see SparseModulus.
   struct Modulus {
     std::vector<Elem> polynomial;
-    std::vector<Elem> reversed_inverse;
+    std::vector<Elem> reversed_inverse{};
     size_t max_quotient_size = 0;
+    SparseModulus<Elem> sparse{};
   };
 
+  // Defaults of SetScheduler: the size of the shorter operand from which a
+  // product is split into tasks and the number of recursion levels split.
+  constexpr static size_t kParallelMinSize = 2048;
+  constexpr static int kParallelDepth = 3;
+
+  /*! @brief Runs the top levels of large products on scheduler, nullptr
+   *  makes all products serial again.
+   *
+   *  The three products of a Karatsuba step are independent. The first depth
+   *  levels of the recursion, while the shorter operand has at least
+   *  min_size coefficients, are expanded into up to 3^depth products with
+   *  their own operands and results. They go to the workers, and the calling
+   *  thread combines them.
+   *
+   *  The setting belongs to the calling thread, products inside the tasks of
+   *  the scheduler stay serial. The caller blocks until the workers are done,
+   *  so it must not be a task of the same scheduler.
+   */
+  static void SetScheduler(runtime::IScheduler* scheduler,
+                           size_t min_size = kParallelMinSize,
+                           int depth = kParallelDepth) {
+    parallelism_ = {scheduler, min_size, depth};
+  }
+
   [[nodiscard]]
-  static std::vector<Elem> Mul(const std::vector<Elem>& a,
-                               const std::vector<Elem>& b) {
+  static std::vector<Elem> Mul(std::span<const Elem> a,
+                               std::span<const Elem> b) {
     if (a.empty() || b.empty()) {
       return {};
     }
     if (a.size() < b.size()) {
-      return MulKaratsuba(b, a);
+      std::swap(a, b);
+    }
+    if (IsParallel(b.size())) {
+      return ForkJoin(a, b, false);
     }
     return MulKaratsuba(a, b);
   }
 
+  [[nodiscard]]
+  static std::vector<Elem> Sqr(std::span<const Elem> a) {
+    if (a.empty()) {
+      return {};
+    }
+    if (IsParallel(a.size())) {
+      return ForkJoin(a, a, true);
+    }
+    return SqrKaratsuba(a);
+  }
+
+  /*! @brief Estimated number of field multiplications in a product of two
+   *  polynomials of the given size, for cost models such as
+   *  solver::Factorizer::ChoosePlan.
+   */
+  [[nodiscard]]
+  static double ProductCost(size_t size) {
+    // Every Karatsuba step replaces a product by three of half the size.
+    double cost = 1;
+    while (size > kKaratsubaThreshold) {
+      size = (size + 1) / 2;
+      cost *= 3;
+    }
+    return cost * static_cast<double>(size) * static_cast<double>(size);
+  }
+
+  // Returns a * b for every b in others. Nothing is shared between the
+  // products, the batch mirrors NttEngine::MulMany.
+  [[nodiscard]]
+  static std::vector<std::vector<Elem>> MulMany(
+      const std::vector<Elem>& a, std::span<const std::vector<Elem>> others) {
+    std::vector<std::vector<Elem>> result;
+    result.reserve(others.size());
+    for (const auto& other : others) {
+      result.push_back(Mul(a, other));
+    }
+    return result;
+  }
+
+  /*! @brief Returns coefficients [from, to) of a * b.
+   *
+   *  The product is cut into blocks of the output and of b of equal size,
+   *  every block is a middle product computed by transposed Karatsuba, so
+   *  coefficients outside of [from, to) are never computed.
+   */
+  [[nodiscard]]
+  static std::vector<Elem> MulMiddle(const std::vector<Elem>& a,
+                                     const std::vector<Elem>& b, size_t from,
+                                     size_t to) {
+    if (a.empty() || b.empty()) {
+      return {};
+    }
+    to = std::min(to, a.size() + b.size() - 1);
+    if (from >= to) {
+      return {};
+    }
+    const size_t size = to - from;
+    const size_t block = std::min(size, b.size());
+
+    std::vector<Elem> result(size, Elem::Zero());
+    std::vector<Elem> window(2 * block - 1);
+    std::vector<Elem> part(block);
+    for (size_t shift = 0; shift < b.size(); shift += block) {
+      std::fill(part.begin(), part.end(), Elem::Zero());
+      std::copy(b.begin() + shift,
+                b.begin() + std::min(shift + block, b.size()), part.begin());
+      for (size_t out = 0; out < size; out += block) {
+        // Coefficients [from + out, from + out + block) of a * part x^shift
+        // depend on a[start, start + 2 * block - 1) only.
+        const auto start = static_cast<ptrdiff_t>(from + out) -
+                           static_cast<ptrdiff_t>(shift + block - 1);
+        const auto end = start + static_cast<ptrdiff_t>(window.size());
+        if (end <= 0 || start >= static_cast<ptrdiff_t>(a.size())) {
+          continue;
+        }
+        for (size_t i = 0; i < window.size(); ++i) {
+          const auto index = start + static_cast<ptrdiff_t>(i);
+          window[i] = index >= 0 && index < static_cast<ptrdiff_t>(a.size())
+                          ? a[index]
+                          : Elem::Zero();
+        }
+        auto middle = MiddleKaratsuba(window, part);
+        for (size_t i = 0; i < block && out + i < size; ++i) {
+          result[out + i] += middle[i];
+        }
+      }
+    }
+    return Trim(std::move(result));
+  }
+
   // assume a.size() >= b.size()
   [[nodiscard]]
   static std::vector<Elem> Rem(std::vector<Elem> a,
@@ -68,6 +207,9 @@ struct KaratsubaEngine {
     if (a.size() < modulus.polynomial.size()) {
       return Trim(std::move(a));
     }
+    if (!modulus.sparse.Empty()) {
+      return modulus.sparse.Rem(std::move(a));
+    }
     if (ShouldUsePlainDiv(a, modulus.polynomial)) {
       return PlainRem(std::move(a), modulus.polynomial);
     }
@@ -99,6 +241,9 @@ struct KaratsubaEngine {
     if (a.size() < modulus.polynomial.size()) {
       return {};
     }
+    if (!modulus.sparse.Empty()) {
+      return modulus.sparse.DivRem(a).first;
+    }
     if (ShouldUsePlainDiv(a, modulus.polynomial)) {
       return PlainDiv(a, modulus.polynomial);
     }
@@ -108,11 +253,10 @@ struct KaratsubaEngine {
     }
 
     std::vector<Elem> rev_a = ReverseTake(a, quotient_size);
-    std::vector<Elem> inv(
-        modulus.reversed_inverse.begin(),
-        modulus.reversed_inverse.begin() +
-            std::min(modulus.reversed_inverse.size(), quotient_size));
-    auto quotient = Mul(std::move(rev_a), inv);
+    const size_t inv_size =
+        std::min(modulus.reversed_inverse.size(), quotient_size);
+    auto quotient =
+        Mul(rev_a, std::span(modulus.reversed_inverse).first(inv_size));
     quotient.resize(quotient_size);
     std::reverse(quotient.begin(), quotient.end());
     return quotient;
@@ -138,6 +282,9 @@ struct KaratsubaEngine {
     if (a.size() < modulus.polynomial.size()) {
       return {{}, Trim(std::move(a))};
     }
+    if (!modulus.sparse.Empty()) {
+      return modulus.sparse.DivRem(std::move(a));
+    }
     if (ShouldUsePlainDiv(a, modulus.polynomial)) {
       return PlainDivRem(std::move(a), modulus.polynomial);
     }
@@ -153,7 +300,11 @@ struct KaratsubaEngine {
     if (polynomial.empty()) {
       return {};
     }
-    if (max_dividend_size < polynomial.size()) {
+    SparseModulus<Elem> sparse(polynomial);
+    if (!sparse.Empty()) {
+      return {.polynomial = polynomial, .sparse = std::move(sparse)};
+    }
+    if (!NeedsInverse(polynomial.size(), max_dividend_size)) {
       return {polynomial, {}, 0};
     }
     const size_t quotient_size = max_dividend_size - polynomial.size() + 1;
@@ -165,14 +316,49 @@ struct KaratsubaEngine {
     };
   }
 
+  // Modulus of polynomial, which is modulus.polynomial divided by divisor.
+  // Since rev(polynomial) rev(divisor) is rev(modulus.polynomial) up to a
+  // constant, the new reversed inverse is the old one times rev(divisor).
+  // Newton's iteration only extends it if the new quotients are longer.
+  [[nodiscard]]
+  static Modulus RebuildModulus(const Modulus& modulus,
+                                const std::vector<Elem>& polynomial,
+                                const std::vector<Elem>& divisor,
+                                size_t max_dividend_size) {
+    if (modulus.max_quotient_size == 0 ||
+        !NeedsInverse(polynomial.size(), max_dividend_size) ||
+        !SparseModulus<Elem>(polynomial).Empty()) {
+      return BuildModulus(polynomial, max_dividend_size);
+    }
+    const size_t quotient_size = max_dividend_size - polynomial.size() + 1;
+    return {
+        polynomial,
+        RebuildReversedInverse(modulus, polynomial, divisor, quotient_size),
+        quotient_size,
+    };
+  }
+
   [[nodiscard]]
   static std::vector<Elem> Gcd(std::vector<Elem> a, std::vector<Elem> b) {
-    return PlainGCD(std::move(a), std::move(b));
+    return HalfGcd<Elem, KaratsubaEngine, kHalfGCDThreshold,
+                   kHalfGCDMinSize>::Gcd(std::move(a), std::move(b));
+  }
+
+  [[nodiscard]]
+  static std::tuple<std::vector<Elem>, std::vector<Elem>, std::vector<Elem>>
+  XGcd(std::vector<Elem> a, std::vector<Elem> b) {
+    return HalfGcd<Elem, KaratsubaEngine, kHalfGCDThreshold,
+                   kHalfGCDMinSize>::XGcd(std::move(a), std::move(b));
+  }
+
+  [[nodiscard]]
+  static std::vector<Elem> InvMod(std::vector<Elem> a,
+                                  const std::vector<Elem>& f) {
+    return HalfGcd<Elem, KaratsubaEngine, kHalfGCDThreshold,
+                   kHalfGCDMinSize>::InvMod(std::move(a), f);
   }
 
  private:
-  constexpr static size_t kKaratsubaThreshold = 128;
-  constexpr static size_t kPlainDivThreshold = 128;
 
   static void TrimInPlace(std::vector<Elem>& a) {
     while (!a.empty() && a.back() == Elem::Zero()) {
@@ -233,6 +419,14 @@ struct KaratsubaEngine {
            a.size() - b.size() + 1 <= kPlainDivThreshold;
   }
 
+  // Dividends of at most max_dividend_size coefficients are divided by a
+  // polynomial of this size by the schoolbook method anyway.
+  [[nodiscard]]
+  static bool NeedsInverse(size_t polynomial_size, size_t max_dividend_size) {
+    return polynomial_size > kPlainDivThreshold &&
+           max_dividend_size >= polynomial_size + kPlainDivThreshold;
+  }
+
   [[nodiscard]]
   static std::vector<Elem> PlainRem(std::vector<Elem> a,
                                     const std::vector<Elem>& b) {
@@ -330,8 +524,21 @@ struct KaratsubaEngine {
     if (std::min(a.size(), b.size()) <= kKaratsubaThreshold) {
       return PlainMul(a, b);
     }
+    if (a.size() < b.size()) {
+      std::swap(a, b);
+    }
+    // The split below leaves the longer operand almost whole on every level,
+    // so unbalanced products are cut into balanced ones first.
+    if (a.size() >= 2 * b.size()) {
+      std::vector<Elem> result(a.size() + b.size() - 1, Elem::Zero());
+      for (size_t start = 0; start < a.size(); start += b.size()) {
+        const size_t size = std::min(b.size(), a.size() - start);
+        AddShifted(result, MulKaratsuba(a.subspan(start, size), b), start);
+      }
+      return Trim(std::move(result));
+    }
 
-    const size_t split = std::min(a.size(), b.size()) / 2;
+    const size_t split = b.size() / 2;
     auto a_low = a.first(split);
     auto a_high = a.subspan(split);
     auto b_low = b.first(split);
@@ -353,6 +560,229 @@ struct KaratsubaEngine {
     return Trim(std::move(result));
   }
 
+  // Every product a[i] * a[j] with i != j occurs twice, so only half of them
+  // is computed and then doubled.
+  [[nodiscard]]
+  static std::vector<Elem> PlainSqr(std::span<const Elem> a) {
+    std::vector<Elem> result(2 * a.size() - 1, Elem::Zero());
+    for (size_t i = 0; i < a.size(); ++i) {
+      if (a[i] == Elem::Zero()) [[unlikely]] {
+        continue;
+      }
+      for (size_t j = i + 1; j < a.size(); ++j) {
+        result[i + j] += a[i] * a[j];
+      }
+    }
+    for (auto& value : result) {
+      value += value;
+    }
+    for (size_t i = 0; i < a.size(); ++i) {
+      result[2 * i] += a[i] * a[i];
+    }
+    return Trim(std::move(result));
+  }
+
+  [[nodiscard]]
+  static std::vector<Elem> SqrKaratsuba(std::span<const Elem> a) {
+    if (a.empty()) {
+      return {};
+    }
+    if (a.size() <= kKaratsubaThreshold) {
+      return PlainSqr(a);
+    }
+
+    const size_t split = a.size() / 2;
+    auto a_low = a.first(split);
+    auto a_high = a.subspan(split);
+
+    // (A1 + A2x)^2 = A1^2 + ((A1 + A2)^2 - A1^2 - A2^2)x + A2^2x^2
+    auto low = SqrKaratsuba(a_low);
+    auto high = SqrKaratsuba(a_high);
+    auto middle = Sub(Sub(SqrKaratsuba(AddParts(a_low, a_high)), low), high);
+
+    std::vector<Elem> result(2 * a.size() - 1, Elem::Zero());
+    AddShifted(result, low, 0);
+    AddShifted(result, middle, split);
+    AddShifted(result, high, 2 * split);
+    return Trim(std::move(result));
+  }
+
+  // Coefficients [n - 1, 2n - 1) of a * b, where n = b.size() and
+  // a.size() = 2n - 1. Trailing zeros are kept.
+  [[nodiscard]]
+  static std::vector<Elem> PlainMiddle(std::span<const Elem> a,
+                                       std::span<const Elem> b) {
+    const size_t n = b.size();
+    std::vector<Elem> result(n, Elem::Zero());
+    for (size_t j = 0; j < n; ++j) {
+      if (b[j] == Elem::Zero()) [[unlikely]] {
+        continue;
+      }
+      const Elem* window = a.data() + n - 1 - j;
+      for (size_t i = 0; i < n; ++i) {
+        result[i] += b[j] * window[i];
+      }
+    }
+    return result;
+  }
+
+  /*! @brief Transposed Karatsuba, the middle product counterpart of
+   *  MulKaratsuba.
+   *
+   *  Let n = 2h and let A0, A1, A2 be the windows of a of size 2h - 1 that
+   *  start at 0, h and 2h. With B = B1 + B2x^h and C = C1 + C2x^h,
+   *    C1 = MP(A1, B1) + MP(A0, B2) = P0 + P2,
+   *    C2 = MP(A2, B1) + MP(A1, B2) = P1 - P2,
+   *  where
+   *    P0 = MP(A0 + A1, B2),  P1 = MP(A1 + A2, B1),  P2 = MP(A1, B1 - B2).
+   *  Odd sizes are padded by one zero in front of b.
+   *
+   *  @pre a.size() == 2 * b.size() - 1.
+   */
+  [[nodiscard]]
+  static std::vector<Elem> MiddleKaratsuba(std::span<const Elem> a,
+                                           std::span<const Elem> b) {
+    const size_t n = b.size();
+    if (n <= kKaratsubaThreshold) {
+      return PlainMiddle(a, b);
+    }
+    if (n % 2 != 0) {
+      std::vector<Elem> a_even(a.begin(), a.end());
+      a_even.resize(2 * n + 1, Elem::Zero());
+      std::vector<Elem> b_even(n + 1, Elem::Zero());
+      std::copy(b.begin(), b.end(), b_even.begin() + 1);
+      auto result = MiddleKaratsuba(a_even, b_even);
+      result.resize(n);
+      return result;
+    }
+
+    const size_t h = n / 2;
+    auto a0 = a.subspan(0, 2 * h - 1);
+    auto a1 = a.subspan(h, 2 * h - 1);
+    auto a2 = a.subspan(2 * h, 2 * h - 1);
+    auto b_low = b.first(h);
+    auto b_high = b.subspan(h);
+
+    std::vector<Elem> a01(a0.begin(), a0.end());
+    std::vector<Elem> a12(a1.begin(), a1.end());
+    for (size_t i = 0; i < a01.size(); ++i) {
+      a01[i] += a1[i];
+      a12[i] += a2[i];
+    }
+    std::vector<Elem> b_diff(b_low.begin(), b_low.end());
+    for (size_t i = 0; i < h; ++i) {
+      b_diff[i] -= b_high[i];
+    }
+
+    auto p0 = MiddleKaratsuba(a01, b_high);
+    auto p1 = MiddleKaratsuba(a12, b_low);
+    auto p2 = MiddleKaratsuba(a1, b_diff);
+
+    std::vector<Elem> result(n);
+    for (size_t i = 0; i < h; ++i) {
+      result[i] = p0[i] + p2[i];
+      result[h + i] = p1[i] - p2[i];
+    }
+    return result;
+  }
+
+  struct Parallelism {
+    runtime::IScheduler* scheduler = nullptr;
+    size_t min_size = kParallelMinSize;
+    int depth = kParallelDepth;
+  };
+
+  inline static thread_local Parallelism parallelism_;
+
+  // A product of the expanded top levels, see SetScheduler. Leaves are the
+  // tasks, inner nodes combine the products of their children.
+  struct ForkNode {
+    std::span<const Elem> a;
+    std::span<const Elem> b;
+    bool square = false;
+    // Operands of the middle product, A1 + A2 and B1 + B2.
+    std::vector<Elem> a_sum{};
+    std::vector<Elem> b_sum{};
+    size_t split = 0;
+    // low, high and middle, empty for a leaf
+    std::vector<ForkNode> children{};
+    std::vector<Elem> product{};
+  };
+
+  [[nodiscard]]
+  static bool IsParallel(size_t size) {
+    return parallelism_.scheduler != nullptr &&
+           size > std::max(parallelism_.min_size, kKaratsubaThreshold);
+  }
+
+  [[nodiscard]]
+  static std::vector<Elem> ForkJoin(std::span<const Elem> a,
+                                    std::span<const Elem> b, bool square) {
+    ForkNode root{.a = a, .b = b, .square = square};
+    std::vector<ForkNode*> tasks;
+    Expand(root, parallelism_.depth, tasks);
+    runtime::ParallelFor(
+        parallelism_.scheduler, tasks.size(), tasks.size(), [&](size_t i) {
+          ForkNode& task = *tasks[i];
+          task.product = task.square ? SqrKaratsuba(task.a)
+                                     : MulKaratsuba(task.a, task.b);
+        });
+    Combine(root);
+    return std::move(root.product);
+  }
+
+  // Splits node the same way as MulKaratsuba and SqrKaratsuba do.
+  static void Expand(ForkNode& node, int depth, std::vector<ForkNode*>& tasks) {
+    const size_t size = std::min(node.a.size(), node.b.size());
+    if (depth == 0 || !IsParallel(size)) {
+      tasks.push_back(&node);
+      return;
+    }
+    node.split = size / 2;
+    // The vector is not resized later, so the spans below stay valid.
+    node.children.resize(3);
+    auto& low = node.children[0];
+    auto& high = node.children[1];
+    auto& middle = node.children[2];
+    low = {.a = node.a.first(node.split),
+           .b = node.b.first(node.split),
+           .square = node.square};
+    high = {.a = node.a.subspan(node.split),
+            .b = node.b.subspan(node.split),
+            .square = node.square};
+    middle.square = node.square;
+    middle.a_sum = AddParts(low.a, high.a);
+    middle.a = middle.a_sum;
+    if (node.square) {
+      middle.b = middle.a;
+    } else {
+      middle.b_sum = AddParts(low.b, high.b);
+      middle.b = middle.b_sum;
+    }
+    for (auto& child : node.children) {
+      Expand(child, depth - 1, tasks);
+    }
+  }
+
+  static void Combine(ForkNode& node) {
+    if (node.children.empty()) {
+      return;
+    }
+    for (auto& child : node.children) {
+      Combine(child);
+    }
+    const auto& low = node.children[0].product;
+    const auto& high = node.children[1].product;
+    auto middle = Sub(Sub(std::move(node.children[2].product), low), high);
+
+    std::vector<Elem> result(node.a.size() + node.b.size() - 1, Elem::Zero());
+    AddShifted(result, low, 0);
+    AddShifted(result, middle, node.split);
+    AddShifted(result, high, 2 * node.split);
+    node.product = Trim(std::move(result));
+    node.children.clear();
+  }
+
   static void AddShifted(std::vector<Elem>& target,
                          const std::vector<Elem>& value, size_t shift) {
     if (value.empty()) {
@@ -377,22 +807,47 @@ struct KaratsubaEngine {
   }
 
   [[nodiscard]]
-  static std::vector<Elem> InverseMod(const std::vector<Elem>& a, size_t size) {
+  static std::vector<Elem> RebuildReversedInverse(
+      const Modulus& modulus, const std::vector<Elem>& polynomial,
+      const std::vector<Elem>& divisor, size_t quotient_size) {
+    const size_t known_size =
+        std::min(modulus.max_quotient_size, quotient_size);
+    std::vector<Elem> inverse(
+        modulus.reversed_inverse.begin(),
+        modulus.reversed_inverse.begin() +
+            std::min(modulus.reversed_inverse.size(), known_size));
+    auto known =
+        MulTrunc(ReverseTake(divisor, known_size), inverse, known_size);
+    // rev(modulus.polynomial) = scale rev(polynomial) rev(divisor).
+    const Elem scale =
+        modulus.polynomial.back() / (polynomial.back() * divisor.back());
+    for (auto& value : known) {
+      value *= scale;
+    }
+    return InverseMod(ReverseTake(polynomial, quotient_size), quotient_size,
+                      known, known_size);
+  }
+
+  // The inverse of a (mod x^size). If known is the inverse modulo
+  // x^known_size, Newton's iteration starts from it.
+  [[nodiscard]]
+  static std::vector<Elem> InverseMod(const std::vector<Elem>& a, size_t size,
+                                      const std::vector<Elem>& known = {},
+                                      size_t known_size = 0) {
+    if (size <= known_size) {
+      return Trim(std::vector<Elem>(
+          known.begin(), known.begin() + std::min(known.size(), size)));
+    }
     if (size == 1) {
       return {a[0].Inverse()};
     }
 
     const size_t k = (size + 1) / 2;
     std::vector<Elem> a1(a.begin(), a.begin() + std::min(a.size(), k));
-    auto b1 = InverseMod(a1, k);
+    auto b1 = InverseMod(a1, k, known, known_size);
 
-    auto product = MulTrunc(a, b1, size);
-    std::vector<Elem> c(size - k, Elem::Zero());
-    if (product.size() > k) {
-      const size_t c_size = std::min(product.size() - k, c.size());
-      std::copy(product.begin() + k, product.begin() + k + c_size, c.begin());
-      TrimInPlace(c);
-    }
+    // a * b1 = 1 (mod x^k), only the next size - k coefficients are needed.
+    auto c = MulMiddle(a, b1, k, size);
 
     auto b2 = MulTrunc(b1, c, size - k);
     for (auto& value : b2) {
@@ -407,18 +862,6 @@ struct KaratsubaEngine {
     }
     return Trim(std::move(g));
   }
-
-  [[nodiscard]]
-  static std::vector<Elem> PlainGCD(std::vector<Elem> a, std::vector<Elem> b) {
-    if (a.size() < b.size()) {
-      a.swap(b);
-    }
-    while (!b.empty()) {
-      a = Rem(std::move(a), b);
-      a.swap(b);
-    }
-    return a;
-  }
 };
 
 }  // namespace factorization::polynomial
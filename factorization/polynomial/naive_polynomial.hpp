@@ -23,6 +23,7 @@
 #pragma once
 
 #include <cstddef>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -69,6 +70,23 @@ class NaivePolynomial : public PolynomialBase<Elem, NaivePolynomial<Elem>> {
     return std::move(*this);
   }
 
+  [[nodiscard]]
+  NaivePolynomial Sqr() const& {
+    if (data_.empty()) {
+      return NaivePolynomial();
+    }
+    return NaivePolynomial(*this).SqrInPlace();
+  }
+
+  [[nodiscard]]
+  NaivePolynomial Sqr() && {
+    if (data_.empty()) {
+      return std::move(*this);
+    }
+    SqrInPlace();
+    return std::move(*this);
+  }
+
   [[nodiscard]]
   NaivePolynomial Div(const NaivePolynomial& rhs) const& {
     // we are zero
@@ -139,6 +157,43 @@ class NaivePolynomial : public PolynomialBase<Elem, NaivePolynomial<Elem>> {
     return std::move(*this).MakeMonic();
   }
 
+  // <gcd, s, t> with s * (*this) + t * b = gcd, gcd is monic
+  [[nodiscard]]
+  std::tuple<NaivePolynomial, NaivePolynomial, NaivePolynomial> XGcd(
+      const NaivePolynomial& b) const {
+    // Invariant:
+    //   r0 = s0 * (*this) + t0 * b,
+    //   r1 = s1 * (*this) + t1 * b.
+    NaivePolynomial r0 = *this;
+    NaivePolynomial r1 = b;
+    NaivePolynomial s0(Element::One());
+    NaivePolynomial s1;
+    NaivePolynomial t0;
+    NaivePolynomial t1(Element::One());
+    while (!r1.IsZero()) {
+      auto [quotient, remainder] = r0.DivRem(r1);
+      r0 = std::exchange(r1, std::move(remainder));
+      s0 = std::exchange(s1, s0.Sub(quotient.Mul(s1)));
+      t0 = std::exchange(t1, t0.Sub(quotient.Mul(t1)));
+    }
+    if (r0.IsZero()) {
+      return {};
+    }
+    const Element leading = r0.data_.back();
+    return {std::move(r0).Div(leading), std::move(s0).Div(leading),
+            std::move(t0).Div(leading)};
+  }
+
+  // Returns zero if *this is not invertible modulo mod
+  [[nodiscard]]
+  NaivePolynomial InvMod(const NaivePolynomial& mod) const {
+    auto [gcd, s, t] = Rem(mod).XGcd(mod);
+    if (!gcd.IsOne()) {
+      return NaivePolynomial();
+    }
+    return s;
+  }
+
   Modulus BuildModulus(size_t) const& {
     return *this;
   }
@@ -182,6 +237,36 @@ class NaivePolynomial : public PolynomialBase<Elem, NaivePolynomial<Elem>> {
     return *this;
   }
 
+  // Nonzero
+  NaivePolynomial& SqrInPlace() {
+    const size_t n = data_.size();
+    std::vector<Element> result(2 * n - 1, Element::Zero());
+
+    const auto* a = data_.data();
+    auto* res = result.data();
+
+    // Every product a[i] * a[j] with i != j occurs twice, so first collect
+    //   sum_{i < j} a[i] a[j] x^{i + j},
+    // then double it and add the squares a[i]^2 x^{2i}.
+    for (size_t i = 0; i < n; ++i) {
+      Element coeff = a[i];
+      if (coeff == Element::Zero()) [[unlikely]] {
+        continue;
+      }
+      for (size_t j = i + 1; j < n; ++j) {
+        res[i + j] += coeff * a[j];
+      }
+    }
+    for (size_t i = 0; i < result.size(); ++i) {
+      res[i] += res[i];
+    }
+    for (size_t i = 0; i < n; ++i) {
+      res[2 * i] += a[i] * a[i];
+    }
+    data_ = std::move(result);
+    return *this;
+  }
+
   // assume division is not by zero
   NaivePolynomial& DivInPlace(const NaivePolynomial& rhs) {
     const size_t n = data_.size();
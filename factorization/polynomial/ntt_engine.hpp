@@ -10,54 +10,143 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
+#include <cmath>
 #include <cstddef>
 #include <cstdint>
+#include <span>
+#include <tuple>
 #include <utility>
 #include <vector>
 
 #include <factorization/concepts.hpp>
+#include <factorization/runtime/parallel_for.hpp>
+
+#include "half_gcd.hpp"
+#include "sparse_modulus.hpp"
 
 namespace factorization::polynomial {
 
 namespace detail {
 
+// Prime of the integer transforms, p - 1 = 2^24 * 150488372227.
+constexpr uint64_t kNttMod = 2524775926340780033;
+constexpr uint64_t kNttGenerator = 3;
+
 // This implementation is taken from
 //   https://codeforces.com/blog/entry/129600?locale=ru
 template <uint64_t kMod, uint64_t kGenerator>
 class IntegerNtt {
  public:
+  // assume result_size == first.size() + second.size() - 1
   [[nodiscard]]
   static std::vector<uint64_t> Convolve(std::vector<uint64_t> first,
                                         std::vector<uint64_t> second,
                                         size_t result_size) {
-    const size_t ntt_size = NttSize(result_size);
-    Montgomery red(kMod);
+    return Product(std::move(first), &second, result_size);
+  }
 
-    Prepare(first, ntt_size, red);
-    Prepare(second, ntt_size, red);
+  // assume result_size == 2 * values.size() - 1
+  [[nodiscard]]
+  static std::vector<uint64_t> Square(std::vector<uint64_t> values,
+                                      size_t result_size) {
+    return Product(std::move(values), nullptr, result_size);
+  }
 
-    const uint64_t inv_n = red.Transform(BinPow(ntt_size, kMod - 2, kMod));
-    const uint64_t root =
-        red.Transform(BinPow(kGenerator, (kMod - 1) / ntt_size, kMod));
-    const uint64_t inv_root =
-        red.Transform(BinPow(red.Reduce(root), kMod - 2, kMod));
-    const auto& rev = BitSort(ntt_size);
+  // Default size from which transforms run on the scheduler given to
+  // SetScheduler.
+  constexpr static size_t kParallelMinSize = size_t{1} << 18;
+
+  /*! @brief Splits transforms of at least min_size points between the
+   *  workers of scheduler, nullptr makes all transforms serial again.
+   *
+   *  A transform of size N = N_1 N_2 is computed by the four-step method:
+   *  N_2 transforms of size N_1 over the columns of an N_1 x N_2 matrix,
+   *  multiplication by twiddle factors, N_1 transforms of size N_2 over its
+   *  rows and a transposition. Transforms of one step are independent and go
+   *  to the workers. The pointwise steps of Transform, MulInPlace and
+   *  InverseTransform are split as well, so all transforms of Convolve and
+   *  Square run in parallel.
+   *
+   *  The setting belongs to the calling thread, transforms inside the tasks
+   *  of the scheduler stay serial. The caller blocks until the workers are
+   *  done, so it must not be a task of the same scheduler.
+   */
+  static void SetScheduler(runtime::IScheduler* scheduler,
+                           size_t min_size = kParallelMinSize) {
+    parallelism_ = {scheduler, min_size};
+  }
 
-    Ntt(first, rev, red, inv_n, root, inv_root, false);
-    Ntt(second, rev, red, inv_n, root, inv_root, false);
-    for (size_t i = 0; i < ntt_size; ++i) {
-      first[i] = red.Multiply(first[i], second[i]);
+  [[nodiscard]]
+  static size_t NttSize(size_t result_size) {
+    size_t ntt_size = 1;
+    while (ntt_size < result_size) {
+      ntt_size <<= 1;
     }
-    Ntt(first, rev, red, inv_n, root, inv_root, true);
+    return ntt_size;
+  }
 
-    first.resize(result_size);
-    for (auto& value : first) {
-      value = red.Reduce(value);
+  // Returns the image of values in the transform domain.
+  // Images of the same size can be multiplied pointwise by MulInPlace and
+  // stored for later reuse, e.g. inside a precomputed modulus.
+  // assume values.size() <= ntt_size
+  [[nodiscard]]
+  static std::vector<uint64_t> Transform(std::vector<uint64_t> values,
+                                         size_t ntt_size) {
+    Montgomery red(kMod);
+    Prepare(values, ntt_size, red);
+    Ntt(values, red, false);
+    return values;
+  }
+
+  // assume image.size() == other.size()
+  static void MulInPlace(std::vector<uint64_t>& image,
+                         const std::vector<uint64_t>& other) {
+    Montgomery red(kMod);
+    ForRanges(image.size(), image.size(), [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i) {
+        image[i] = red.Multiply(image[i], other[i]);
+      }
+    });
+  }
+
+  // Adds the pointwise product of first and second to image, so a sum of
+  // products is restored by a single InverseTransform.
+  // assume image.size() == first.size() == second.size()
+  static void AddProductInPlace(std::vector<uint64_t>& image,
+                                const std::vector<uint64_t>& first,
+                                const std::vector<uint64_t>& second) {
+    Montgomery red(kMod);
+    for (size_t i = 0; i < image.size(); ++i) {
+      const uint64_t value = red.Multiply(first[i], second[i]);
+      image[i] = image[i] + value < kMod ? image[i] + value
+                                         : image[i] + value - kMod;
     }
-    return first;
+  }
+
+  // Restores the first result_size coefficients of the cyclic convolution
+  // represented by image.
+  [[nodiscard]]
+  static std::vector<uint64_t> InverseTransform(std::vector<uint64_t> image,
+                                                size_t result_size) {
+    Montgomery red(kMod);
+    const size_t ntt_size = image.size();
+    Ntt(image, red, true);
+    image.resize(result_size);
+    ForRanges(ntt_size, result_size, [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i) {
+        image[i] = red.Reduce(image[i]);
+      }
+    });
+    return image;
   }
 
  private:
+  struct Parallelism {
+    runtime::IScheduler* scheduler = nullptr;
+    size_t min_size = kParallelMinSize;
+  };
+
   struct Montgomery {
     uint64_t n;
     uint64_t nr;
@@ -92,6 +181,134 @@ class IntegerNtt {
     }
   };
 
+  // Products whose padded transform would be shorter than this always pad.
+  constexpr static size_t kMinWrapSize = 64;
+  // Number of tasks of every parallel step.
+  constexpr static size_t kParallelChunks = 64;
+
+  inline static thread_local Parallelism parallelism_;
+
+  /*! @brief Computes the product of first and second, or the square of first
+   *  if second is nullptr.
+   *
+   *  Padding to NttSize(result_size) almost doubles the work when the result
+   *  is slightly longer than a power of two. Let
+   *    result_size = half + low,  half = NttSize(result_size) / 2,  low <= half.
+   *  The product c modulo x^half - 1 is
+   *    cyclic[i] = c[i] + c[i + half],  i < low,
+   *    cyclic[i] = c[i],                low <= i < half.
+   *  The first low coefficients of c depend only on the first low coefficients
+   *  of the operands, so they are computed by a recursive product of these
+   *  prefixes and then
+   *    c[i + half] = cyclic[i] - c[i].
+   *  The integers are exact, so the subtraction is done modulo kMod.
+   *  WrapCost decides which of the two ways is cheaper.
+   */
+  [[nodiscard]]
+  static std::vector<uint64_t> Product(std::vector<uint64_t> first,
+                                       const std::vector<uint64_t>* second,
+                                       size_t result_size) {
+    const size_t ntt_size = NttSize(result_size);
+    if (!ShouldWrap(result_size)) {
+      return Cyclic(std::move(first), second, ntt_size, result_size);
+    }
+
+    const size_t half = ntt_size / 2;
+    const size_t low = result_size - half;
+
+    std::vector<uint64_t> first_low(first.begin(),
+                                    first.begin() +
+                                        std::min(first.size(), low));
+    std::vector<uint64_t> low_product;
+    if (second == nullptr) {
+      low_product = Square(std::move(first_low), 2 * first_low.size() - 1);
+    } else {
+      std::vector<uint64_t> second_low(
+          second->begin(), second->begin() + std::min(second->size(), low));
+      const size_t low_size = first_low.size() + second_low.size() - 1;
+      low_product =
+          Convolve(std::move(first_low), std::move(second_low), low_size);
+    }
+    low_product.resize(low, 0);
+
+    auto result = Cyclic(std::move(first), second, half, half);
+    result.resize(result_size);
+    for (size_t i = 0; i < low; ++i) {
+      const uint64_t value = result[i];
+      result[i] = low_product[i];
+      result[i + half] = value >= low_product[i]
+                             ? value - low_product[i]
+                             : value + kMod - low_product[i];
+    }
+    return result;
+  }
+
+  // First result_size coefficients of the product modulo x^ntt_size - 1.
+  [[nodiscard]]
+  static std::vector<uint64_t> Cyclic(std::vector<uint64_t> first,
+                                      const std::vector<uint64_t>* second,
+                                      size_t ntt_size, size_t result_size) {
+    auto image = Transform(Fold(std::move(first), ntt_size), ntt_size);
+    if (second == nullptr) {
+      MulInPlace(image, image);
+    } else {
+      MulInPlace(image, Transform(Fold(*second, ntt_size), ntt_size));
+    }
+    return InverseTransform(std::move(image),
+                            std::min(result_size, ntt_size));
+  }
+
+  // Returns values (mod x^size - 1).
+  [[nodiscard]]
+  static std::vector<uint64_t> Fold(std::vector<uint64_t> values,
+                                    size_t size) {
+    if (values.size() <= size) {
+      return values;
+    }
+    for (size_t i = size; i < values.size(); ++i) {
+      uint64_t& target = values[i % size];
+      target = target + values[i] < kMod ? target + values[i]
+                                         : target + values[i] - kMod;
+    }
+    values.resize(size);
+    return values;
+  }
+
+  // Rough cost of a product padded to ntt_size: three transforms.
+  [[nodiscard]]
+  static size_t PaddedCost(size_t ntt_size) {
+    size_t log = 0;
+    while ((size_t{1} << log) < ntt_size) {
+      ++log;
+    }
+    return 3 * ntt_size * (log + 1);
+  }
+
+  [[nodiscard]]
+  static size_t ProductCost(size_t result_size) {
+    const size_t ntt_size = NttSize(result_size);
+    if (ntt_size < kMinWrapSize || ntt_size == result_size) {
+      return PaddedCost(ntt_size);
+    }
+    return std::min(PaddedCost(ntt_size), WrapCost(result_size));
+  }
+
+  // assume NttSize(result_size) > result_size
+  [[nodiscard]]
+  static size_t WrapCost(size_t result_size) {
+    const size_t half = NttSize(result_size) / 2;
+    return PaddedCost(half) + ProductCost(2 * (result_size - half) - 1);
+  }
+
+  [[nodiscard]]
+  static bool ShouldWrap(size_t result_size) {
+    const size_t ntt_size = NttSize(result_size);
+    if (ntt_size < kMinWrapSize || ntt_size == result_size) {
+      return false;
+    }
+    return WrapCost(result_size) < PaddedCost(ntt_size);
+  }
+
   [[nodiscard]]
   static uint64_t BinPow(uint64_t base, uint64_t power, uint64_t mod) {
     uint64_t result = 1;
@@ -105,22 +322,38 @@ class IntegerNtt {
     return result;
   }
 
-  [[nodiscard]]
-  static size_t NttSize(size_t result_size) {
-    size_t ntt_size = 1;
-    while (ntt_size < result_size) {
-      ntt_size <<= 1;
-    }
-    return ntt_size;
-  }
-
   static void Prepare(std::vector<uint64_t>& values, size_t ntt_size,
                       const Montgomery& red) {
     const size_t old_size = values.size();
     values.resize(ntt_size);
-    for (size_t i = 0; i < old_size; ++i) {
-      values[i] = red.Transform(values[i]);
+    ForRanges(ntt_size, old_size, [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i) {
+        values[i] = red.Transform(values[i]);
+      }
+    });
+  }
+
+  [[nodiscard]]
+  static bool IsParallel(size_t ntt_size) {
+    // The four-step method needs both dimensions to be at least two.
+    return parallelism_.scheduler != nullptr &&
+           ntt_size >= std::max<size_t>(parallelism_.min_size, 4);
+  }
+
+  // Calls body(begin, end) for ranges covering [0, count). They go to the
+  // workers if a transform of ntt_size points is parallel, otherwise there
+  // is a single range.
+  template <typename F>
+  static void ForRanges(size_t ntt_size, size_t count, F&& body) {
+    if (!IsParallel(ntt_size)) {
+      body(size_t{0}, count);
+      return;
     }
+    runtime::ParallelFor(parallelism_.scheduler, kParallelChunks,
+                         kParallelChunks, [&](size_t chunk) {
+                           body(count * chunk / kParallelChunks,
+                                count * (chunk + 1) / kParallelChunks);
+                         });
   }
 
   [[nodiscard]]
@@ -141,30 +374,127 @@ class IntegerNtt {
     return rev;
   }
 
-  static void Ntt(std::vector<uint64_t>& values, const std::vector<int>& rev,
-                  const Montgomery& red, uint64_t inv_n, uint64_t root,
-                  uint64_t inv_root, bool invert) {
-    const auto size = static_cast<int>(values.size());
+  // Powers of the primitive root of degree 2^log, or of its inverse, in
+  // Montgomery form. Tables are kept per thread, so repeated transforms of
+  // the same size do not recompute them.
+  [[nodiscard]]
+  static const std::vector<uint64_t>& Roots(int log, bool invert,
+                                            const Montgomery& red) {
+    static thread_local std::array<std::vector<uint64_t>, 128> cache;
+    auto& roots = cache[2 * log + (invert ? 1 : 0)];
+    const size_t size = size_t{1} << log;
+    if (roots.size() == size / 2) {
+      return roots;
+    }
 
-    for (int i = 0; i < size; ++i) {
-      if (i < rev[i]) {
-        std::swap(values[i], values[rev[i]]);
+    const uint64_t root =
+        red.Transform(BinPow(kGenerator, (kMod - 1) / size, kMod));
+    const uint64_t step =
+        invert ? red.Transform(BinPow(red.Reduce(root), kMod - 2, kMod))
+               : root;
+    roots.resize(size / 2);
+    roots[0] = red.Transform(1);
+    for (size_t i = 1; i < size / 2; ++i) {
+      roots[i] = red.Multiply(roots[i - 1], step);
+    }
+    return roots;
+  }
+
+  static void Ntt(std::vector<uint64_t>& values, const Montgomery& red,
+                  bool invert) {
+    if (IsParallel(values.size())) {
+      ParallelNtt(values, red, invert);
+      return;
+    }
+    Butterflies(values.data(), values.size(), red, invert);
+    if (invert) {
+      const uint64_t inv_n =
+          red.Transform(BinPow(values.size(), kMod - 2, kMod));
+      for (auto& value : values) {
+        value = red.Multiply(value, inv_n);
       }
     }
+  }
 
-    const uint64_t step = invert ? inv_root : root;
-    std::vector<uint64_t> roots(size >> 1);
-    if (!roots.empty()) {
-      roots[0] = red.Transform(1);
+  /*! @brief Four-step transform, see SetScheduler.
+   *
+   *  With n = n_1 N_2 + n_2 and k = k_1 + N_1 k_2 the transform is
+   *    X[k] = sum_{n_2} w_{N_2}^{n_2 k_2} w^{n_2 k_1}
+   *             sum_{n_1} w_{N_1}^{n_1 k_1} x[n],
+   *  where w_{N_i} = w^{N / N_i}. Every step reads its input through a
+   *  transposition, so the short transforms work on contiguous rows.
+   */
+  static void ParallelNtt(std::vector<uint64_t>& values, const Montgomery& red,
+                          bool invert) {
+    const size_t size = values.size();
+    int log = 0;
+    while ((size_t{1} << log) < size) {
+      ++log;
     }
-    for (int i = 1; i < (size >> 1); ++i) {
-      roots[i] = red.Multiply(roots[i - 1], step);
+    const size_t rows = size_t{1} << (log / 2);  // N_1
+    const size_t columns = size / rows;          // N_2
+    // Powers w^i for i < size / 2, w^(i + size / 2) = -w^i.
+    const auto& roots = Roots(log, invert, red);
+    const uint64_t scale =
+        red.Transform(invert ? BinPow(size, kMod - 2, kMod) : 1);
+    std::vector<uint64_t> buffer(size);
+
+    // buffer[n_2][k_1] = w^{n_2 k_1} sum_{n_1} w_{N_1}^{n_1 k_1} x[n].
+    ForRanges(size, columns, [&](size_t begin, size_t end) {
+      for (size_t n2 = begin; n2 < end; ++n2) {
+        uint64_t* row = buffer.data() + n2 * rows;
+        for (size_t n1 = 0; n1 < rows; ++n1) {
+          row[n1] = values[n1 * columns + n2];
+        }
+        Butterflies(row, rows, red, invert);
+        for (size_t k1 = 1; k1 < rows; ++k1) {
+          const size_t power = n2 * k1;
+          const uint64_t twiddle = power < size / 2
+                                       ? roots[power]
+                                       : kMod - roots[power - size / 2];
+          row[k1] = red.Multiply(row[k1], twiddle);
+        }
+      }
+    });
+    // values[k_1][k_2] = X[k_1 + N_1 k_2].
+    ForRanges(size, rows, [&](size_t begin, size_t end) {
+      for (size_t k1 = begin; k1 < end; ++k1) {
+        uint64_t* row = values.data() + k1 * columns;
+        for (size_t n2 = 0; n2 < columns; ++n2) {
+          row[n2] = buffer[n2 * rows + k1];
+        }
+        Butterflies(row, columns, red, invert);
+      }
+    });
+    // Back to the natural order, the inverse transform is scaled by 1 / N.
+    ForRanges(size, columns, [&](size_t begin, size_t end) {
+      for (size_t k2 = begin; k2 < end; ++k2) {
+        for (size_t k1 = 0; k1 < rows; ++k1) {
+          const uint64_t value = values[k1 * columns + k2];
+          buffer[k2 * rows + k1] = invert ? red.Multiply(value, scale) : value;
+        }
+      }
+    });
+    values.swap(buffer);
+  }
+
+  // Transform of size points in place, the inverse one is not scaled.
+  static void Butterflies(uint64_t* values, size_t count, const Montgomery& red,
+                          bool invert) {
+    const auto size = static_cast<int>(count);
+    const auto& rev = BitSort(count);
+
+    for (int i = 0; i < size; ++i) {
+      if (i < rev[i]) {
+        std::swap(values[i], values[rev[i]]);
+      }
     }
 
     int log = 0;
     while ((1 << log) < size) {
       ++log;
     }
+    const auto& roots = Roots(log, invert, red);
     for (int level = 0; level < log; ++level) {
       for (int i = 0; i < size; ++i) {
         if ((i & (1 << level)) != 0) {
@@ -179,38 +509,63 @@ class IntegerNtt {
                                              : values[i] + value - kMod;
       }
     }
-
-    if (invert) {
-      for (auto& value : values) {
-        value = red.Multiply(value, inv_n);
-      }
-    }
   }
 };
 
 }  // namespace detail
 
-template <concepts::GaloisFieldElement Elem>
+// Divisions with a divisor or a quotient of at most kPlainDivThreshold
+// coefficients are done by the schoolbook method.
+template <concepts::GaloisFieldElement Elem, size_t kPlainDivThreshold = 128>
 struct NttEngine {
   static_assert(Elem::FieldPower() == 1, "NttEngine requires prime field");
 
-  // The Half-GCD routines in this engine follow the structure of NTL's ZZ_pEX
-  // HalfGCD/GCD implementation, adapted to this polynomial representation.
+  // Below this size Gcd runs the Euclidean algorithm, see HalfGcd.
   constexpr static size_t kHalfGCDThreshold = 512;
 
-  struct HalfGCDMatrix {
-    std::vector<Elem> data[2][2];
-  };
-
+  // Besides coefficients, the modulus keeps NTT images of its operands, so
+  // Div and Rem do not transform them again for every dividend:
+  //   - reversed_inverse_image is the image of reversed_inverse whose size is
+  //     enough for any quotient up to max_quotient_size;
+  //   - polynomial_image is the image of polynomial (mod x^k - 1), where
+  //     k >= deg(polynomial). It is used to restore the remainder from the
+  //     quotient by a wrap-around product, see SubProduct.
+  // The inverse and the images are empty if the plain division is always
+  // used.
+  // Sparse moduli skip all of the above, see SparseModulus.
   struct Modulus {
     std::vector<Elem> polynomial;
-    std::vector<Elem> reversed_inverse;
+    std::vector<Elem> reversed_inverse{};
     size_t max_quotient_size = 0;
+    std::vector<uint64_t> reversed_inverse_image{};
+    std::vector<uint64_t> polynomial_image{};
+    SparseModulus<Elem> sparse{};
   };
 
+  // Splits large transforms of the calling thread between the workers of
+  // scheduler, see IntegerNtt::SetScheduler. The setting is shared by all
+  // engines built on integer transforms.
+  static void SetScheduler(runtime::IScheduler* scheduler,
+                           size_t min_size = Ntt::kParallelMinSize) {
+    Ntt::SetScheduler(scheduler, min_size);
+  }
+
+  /*! @brief Checks that products are exact for operands of this size.
+   *
+   *  Coefficients of the integer convolution are sums of at most size
+   *  products of values below p, they must not exceed the NTT prime. The
+   *  only exception is p equal to the NTT prime itself.
+   */
   [[nodiscard]]
-  static std::vector<Elem> Mul(const std::vector<Elem>& a,
-                               const std::vector<Elem>& b) {
+  constexpr static bool IsExact(size_t size) {
+    const auto p = static_cast<__uint128_t>(Elem::FieldBase());
+    return p == detail::kNttMod || size == 0 ||
+           (p - 1) * (p - 1) <= (detail::kNttMod - 1) / size;
+  }
+
+  [[nodiscard]]
+  static std::vector<Elem> Mul(std::span<const Elem> a,
+                               std::span<const Elem> b) {
     if (a.empty() || b.empty()) {
       return {};
     }
@@ -218,6 +573,148 @@ struct NttEngine {
     return MulNtt(a, b, result_size);
   }
 
+  // The operand is transformed only once.
+  [[nodiscard]]
+  static std::vector<Elem> Sqr(std::span<const Elem> a) {
+    if (a.empty()) {
+      return {};
+    }
+    return Trim(FromIntegers(
+        Ntt::Square(ToIntegers(a, a.size()), 2 * a.size() - 1)));
+  }
+
+  /*! @brief Estimated number of field multiplications in a product of two
+   *  polynomials of the given size, see KaratsubaEngine::ProductCost.
+   *
+   *  A product takes three transforms of N log2(N) / 2 butterflies each.
+   */
+  [[nodiscard]]
+  static double ProductCost(size_t size) {
+    if (size == 0) {
+      return 0;
+    }
+    const auto ntt_size = static_cast<double>(Ntt::NttSize(2 * size - 1));
+    return 1.5 * ntt_size * std::log2(ntt_size);
+  }
+
+  /*! @brief Returns coefficients [from, to) of a * b.
+   *
+   *  Coefficients of a * b (mod x^k - 1) in [from, to) are not mixed with
+   *  others as long as k >= to and k >= a.size() + b.size() - 1 - from, so the
+   *  transform size follows the number of needed coefficients rather than the
+   *  size of the whole product.
+   */
+  [[nodiscard]]
+  static std::vector<Elem> MulMiddle(const std::vector<Elem>& a,
+                                     const std::vector<Elem>& b, size_t from,
+                                     size_t to) {
+    if (a.empty() || b.empty()) {
+      return {};
+    }
+    // Coefficients of the operands starting from `to` do not matter.
+    const size_t a_size = std::min(a.size(), to);
+    const size_t b_size = std::min(b.size(), to);
+    to = std::min(to, a_size + b_size - 1);
+    if (from >= to) {
+      return {};
+    }
+    const size_t ntt_size =
+        Ntt::NttSize(std::max(to, a_size + b_size - 1 - from));
+
+    auto product = Ntt::Transform(
+        ToIntegers(std::span(a).first(a_size), ntt_size), ntt_size);
+    Ntt::MulInPlace(product, Image(std::span(b).first(b_size), ntt_size));
+    product = Ntt::InverseTransform(std::move(product), to);
+    product.erase(product.begin(), product.begin() + from);
+    return Trim(FromIntegers(product));
+  }
+
+  /*! @brief Returns a * b for every b in others.
+   *
+   *  a is transformed once, at the size of the longest product.
+   */
+  [[nodiscard]]
+  static std::vector<std::vector<Elem>> MulMany(
+      const std::vector<Elem>& a, std::span<const std::vector<Elem>> others) {
+    std::vector<const std::vector<Elem>*> rhs;
+    rhs.reserve(others.size());
+    for (const auto& other : others) {
+      rhs.push_back(&other);
+    }
+    const std::array<const std::vector<Elem>*, 1> lhs{&a};
+    return MulMatrix(lhs, rhs, 1);
+  }
+
+  /*! @brief Returns the product of polynomial matrices lhs and rhs.
+   *
+   *  lhs has inner columns and rhs has inner rows, both are stored by rows,
+   *  and so is the result. Every entry is transformed once and sums of
+   *  products are taken in the transform domain: a product of 2 x 2 matrices
+   *  needs 8 forward and 4 inverse transforms instead of 24 transforms of
+   *  separate products. All transforms have the size of the longest product.
+   */
+  [[nodiscard]]
+  static std::vector<std::vector<Elem>> MulMatrix(
+      std::span<const std::vector<Elem>* const> lhs,
+      std::span<const std::vector<Elem>* const> rhs, size_t inner) {
+    const size_t rows = lhs.size() / inner;
+    const size_t columns = rhs.size() / inner;
+    std::vector<std::vector<Elem>> result(rows * columns);
+
+    size_t lhs_size = 0;
+    size_t rhs_size = 0;
+    for (const auto* entry : lhs) {
+      lhs_size = std::max(lhs_size, entry->size());
+    }
+    for (const auto* entry : rhs) {
+      rhs_size = std::max(rhs_size, entry->size());
+    }
+    if (lhs_size == 0 || rhs_size == 0) {
+      return result;
+    }
+
+    const size_t ntt_size = Ntt::NttSize(lhs_size + rhs_size - 1);
+    auto images = [ntt_size](std::span<const std::vector<Elem>* const> entries) {
+      std::vector<std::vector<uint64_t>> result;
+      result.reserve(entries.size());
+      for (const auto* entry : entries) {
+        result.push_back(entry->empty() ? std::vector<uint64_t>()
+                                        : Image(*entry, ntt_size));
+      }
+      return result;
+    };
+    const auto lhs_images = images(lhs);
+    const auto rhs_images = images(rhs);
+
+    for (size_t i = 0; i < rows; ++i) {
+      for (size_t k = 0; k < columns; ++k) {
+        std::vector<uint64_t> sum;
+        size_t result_size = 0;
+        for (size_t j = 0; j < inner; ++j) {
+          const auto& first = lhs_images[i * inner + j];
+          const auto& second = rhs_images[j * columns + k];
+          if (first.empty() || second.empty()) {
+            continue;
+          }
+          result_size = std::max(result_size, lhs[i * inner + j]->size() +
+                                                  rhs[j * columns + k]->size() -
+                                                  1);
+          if (sum.empty()) {
+            sum = first;
+            Ntt::MulInPlace(sum, second);
+          } else {
+            Ntt::AddProductInPlace(sum, first, second);
+          }
+        }
+        if (!sum.empty()) {
+          result[i * columns + k] = Trim(FromIntegers(
+              Ntt::InverseTransform(std::move(sum), result_size)));
+        }
+      }
+    }
+    return result;
+  }
+
   // assume a.size() >= b.size()
   [[nodiscard]]
   static std::vector<Elem> Rem(std::vector<Elem> a,
@@ -226,7 +723,7 @@ struct NttEngine {
       return PlainRem(std::move(a), b);
     }
     auto quotient = Div(a, b);
-    return Sub(std::move(a), Mul(std::move(quotient), b), b.size() - 1);
+    return SubProduct(a, quotient, PolynomialImage(b), b.size());
   }
 
   [[nodiscard]]
@@ -234,12 +731,14 @@ struct NttEngine {
     if (a.size() < modulus.polynomial.size()) {
       return Trim(std::move(a));
     }
+    if (!modulus.sparse.Empty()) {
+      return modulus.sparse.Rem(std::move(a));
+    }
     if (ShouldUsePlainDiv(a, modulus.polynomial)) {
       return PlainRem(std::move(a), modulus.polynomial);
     }
     auto quotient = Div(a, modulus);
-    return Sub(std::move(a), Mul(std::move(quotient), modulus.polynomial),
-               modulus.polynomial.size() - 1);
+    return SubProduct(a, quotient, modulus);
   }
 
   // assume a.size() >= b.size()
@@ -265,6 +764,9 @@ struct NttEngine {
     if (a.size() < modulus.polynomial.size()) {
       return {};
     }
+    if (!modulus.sparse.Empty()) {
+      return modulus.sparse.DivRem(a).first;
+    }
     if (ShouldUsePlainDiv(a, modulus.polynomial)) {
       return PlainDiv(a, modulus.polynomial);
     }
@@ -274,11 +776,20 @@ struct NttEngine {
     }
 
     std::vector<Elem> rev_a = ReverseTake(a, quotient_size);
-    std::vector<Elem> inv(
-        modulus.reversed_inverse.begin(),
-        modulus.reversed_inverse.begin() +
-            std::min(modulus.reversed_inverse.size(), quotient_size));
-    auto quotient = Mul(std::move(rev_a), inv);
+    const size_t inv_size =
+        std::min(modulus.reversed_inverse.size(), quotient_size);
+    std::vector<Elem> quotient;
+    // The stored image has the size for the longest quotient.
+    // For much shorter quotients a fresh product of truncated operands is
+    // cheaper than a long transform.
+    if (!modulus.reversed_inverse_image.empty() &&
+        modulus.reversed_inverse_image.size() <=
+            Ntt::NttSize(rev_a.size() + inv_size - 1)) {
+      quotient = MulImage(rev_a, modulus.reversed_inverse_image, quotient_size);
+    } else {
+      quotient =
+          Mul(rev_a, std::span(modulus.reversed_inverse).first(inv_size));
+    }
     quotient.resize(quotient_size);
     std::reverse(quotient.begin(), quotient.end());
     return quotient;
@@ -294,7 +805,7 @@ struct NttEngine {
       return PlainDivRem(std::move(a), b);
     }
     auto quotient = Div(a, b);
-    auto remainder = Sub(std::move(a), Mul(quotient, b), b.size() - 1);
+    auto remainder = SubProduct(a, quotient, PolynomialImage(b), b.size());
     return {std::move(quotient), std::move(remainder)};
   }
 
@@ -304,12 +815,14 @@ struct NttEngine {
     if (a.size() < modulus.polynomial.size()) {
       return {{}, Trim(std::move(a))};
     }
+    if (!modulus.sparse.Empty()) {
+      return modulus.sparse.DivRem(std::move(a));
+    }
     if (ShouldUsePlainDiv(a, modulus.polynomial)) {
       return PlainDivRem(std::move(a), modulus.polynomial);
     }
     auto quotient = Div(a, modulus);
-    auto remainder = Sub(std::move(a), Mul(quotient, modulus.polynomial),
-                         modulus.polynomial.size() - 1);
+    auto remainder = SubProduct(a, quotient, modulus);
     return {std::move(quotient), std::move(remainder)};
   }
 
@@ -319,29 +832,67 @@ struct NttEngine {
     if (polynomial.empty()) {
       return {};
     }
-    if (max_dividend_size < polynomial.size()) {
+    SparseModulus<Elem> sparse(polynomial);
+    if (!sparse.Empty()) {
+      return {.polynomial = polynomial, .sparse = std::move(sparse)};
+    }
+    if (!NeedsInverse(polynomial.size(), max_dividend_size)) {
       return {polynomial, {}, 0};
     }
     const size_t quotient_size = max_dividend_size - polynomial.size() + 1;
     std::vector<Elem> rev_polynomial = ReverseTake(polynomial, quotient_size);
-    return {
+    return WithImages({
         polynomial,
         InverseMod(rev_polynomial, quotient_size),
         quotient_size,
-    };
+    });
+  }
+
+  // Modulus of polynomial, which is modulus.polynomial divided by divisor.
+  // Since rev(polynomial) rev(divisor) is rev(modulus.polynomial) up to a
+  // constant, the new reversed inverse is the old one times rev(divisor).
+  // Newton's iteration only extends it if the new quotients are longer.
+  // The images are transformed again.
+  [[nodiscard]]
+  static Modulus RebuildModulus(const Modulus& modulus,
+                                const std::vector<Elem>& polynomial,
+                                const std::vector<Elem>& divisor,
+                                size_t max_dividend_size) {
+    if (modulus.max_quotient_size == 0 ||
+        !NeedsInverse(polynomial.size(), max_dividend_size) ||
+        !SparseModulus<Elem>(polynomial).Empty()) {
+      return BuildModulus(polynomial, max_dividend_size);
+    }
+    const size_t quotient_size = max_dividend_size - polynomial.size() + 1;
+    return WithImages({
+        polynomial,
+        RebuildReversedInverse(modulus, polynomial, divisor, quotient_size),
+        quotient_size,
+    });
   }
 
   [[nodiscard]]
   static std::vector<Elem> Gcd(std::vector<Elem> a, std::vector<Elem> b) {
-    return HalfGCDImpl(std::move(a), std::move(b));
-    // return PlainGCD(std::move(a), std::move(b));
+    return HalfGcd<Elem, NttEngine, kHalfGCDThreshold>::Gcd(std::move(a),
+                                                             std::move(b));
   }
 
- private:
-  constexpr static uint64_t kNttMod = 2524775926340780033;
-  constexpr static uint64_t kNttGenerator = 3;
+  [[nodiscard]]
+  static std::tuple<std::vector<Elem>, std::vector<Elem>, std::vector<Elem>>
+  XGcd(std::vector<Elem> a, std::vector<Elem> b) {
+    return HalfGcd<Elem, NttEngine, kHalfGCDThreshold>::XGcd(std::move(a),
+                                                              std::move(b));
+  }
 
-  constexpr static size_t kPlainDivThreshold = 128;
+  [[nodiscard]]
+  static std::vector<Elem> InvMod(std::vector<Elem> a,
+                                  const std::vector<Elem>& f) {
+    return HalfGcd<Elem, NttEngine, kHalfGCDThreshold>::InvMod(std::move(a),
+                                                                f);
+  }
+
+ private:
+  using Ntt = detail::IntegerNtt<detail::kNttMod, detail::kNttGenerator>;
 
   static void TrimInPlace(std::vector<Elem>& a) {
     while (!a.empty() && a.back() == Elem::Zero()) {
@@ -390,6 +941,26 @@ struct NttEngine {
            a.size() - b.size() + 1 <= kPlainDivThreshold;
   }
 
+  // Dividends of at most max_dividend_size coefficients are divided by a
+  // polynomial of this size by the schoolbook method anyway.
+  [[nodiscard]]
+  static bool NeedsInverse(size_t polynomial_size, size_t max_dividend_size) {
+    return polynomial_size > kPlainDivThreshold &&
+           max_dividend_size >= polynomial_size + kPlainDivThreshold;
+  }
+
+  // Any product of a reversed dividend of size at most max_quotient_size and
+  // reversed_inverse fits into the image of the latter without wrap-around.
+  [[nodiscard]]
+  static Modulus WithImages(Modulus modulus) {
+    modulus.polynomial_image = PolynomialImage(modulus.polynomial);
+    modulus.reversed_inverse_image =
+        Image(modulus.reversed_inverse,
+              Ntt::NttSize(modulus.max_quotient_size +
+                           modulus.reversed_inverse.size() - 1));
+    return modulus;
+  }
+
   [[nodiscard]]
   static std::vector<Elem> PlainRem(std::vector<Elem> a,
                                     const std::vector<Elem>& b) {
@@ -449,22 +1020,47 @@ struct NttEngine {
   }
 
   [[nodiscard]]
-  static std::vector<Elem> InverseMod(const std::vector<Elem>& a, size_t size) {
+  static std::vector<Elem> RebuildReversedInverse(
+      const Modulus& modulus, const std::vector<Elem>& polynomial,
+      const std::vector<Elem>& divisor, size_t quotient_size) {
+    const size_t known_size =
+        std::min(modulus.max_quotient_size, quotient_size);
+    std::vector<Elem> inverse(
+        modulus.reversed_inverse.begin(),
+        modulus.reversed_inverse.begin() +
+            std::min(modulus.reversed_inverse.size(), known_size));
+    auto known =
+        MulTrunc(ReverseTake(divisor, known_size), inverse, known_size);
+    // rev(modulus.polynomial) = scale rev(polynomial) rev(divisor).
+    const Elem scale =
+        modulus.polynomial.back() / (polynomial.back() * divisor.back());
+    for (auto& value : known) {
+      value *= scale;
+    }
+    return InverseMod(ReverseTake(polynomial, quotient_size), quotient_size,
+                      known, known_size);
+  }
+
+  // The inverse of a (mod x^size). If known is the inverse modulo
+  // x^known_size, Newton's iteration starts from it.
+  [[nodiscard]]
+  static std::vector<Elem> InverseMod(const std::vector<Elem>& a, size_t size,
+                                      const std::vector<Elem>& known = {},
+                                      size_t known_size = 0) {
+    if (size <= known_size) {
+      return Trim(std::vector<Elem>(
+          known.begin(), known.begin() + std::min(known.size(), size)));
+    }
     if (size == 1) {
       return {a[0].Inverse()};
     }
 
     const size_t k = (size + 1) / 2;
     std::vector<Elem> a1(a.begin(), a.begin() + std::min(a.size(), k));
-    auto b1 = InverseMod(a1, k);
+    auto b1 = InverseMod(a1, k, known, known_size);
 
-    auto product = MulTrunc(a, b1, size);
-    std::vector<Elem> c(size - k, Elem::Zero());
-    if (product.size() > k) {
-      const size_t c_size = std::min(product.size() - k, c.size());
-      std::copy(product.begin() + k, product.begin() + k + c_size, c.begin());
-      TrimInPlace(c);
-    }
+    // a * b1 = 1 (mod x^k), only the next size - k coefficients are needed.
+    auto c = MulMiddle(a, b1, k, size);
 
     auto b2 = MulTrunc(b1, c, size - k);
     for (auto& value : b2) {
@@ -481,296 +1077,116 @@ struct NttEngine {
   }
 
   [[nodiscard]]
-  static std::vector<Elem> PlainGCD(std::vector<Elem> a, std::vector<Elem> b) {
-    if (a.size() < b.size()) {
-      a.swap(b);
-    }
-    while (!b.empty()) {
-      a = Rem(std::move(a), b);
-      a.swap(b);
-    }
-    return a;
+  static std::vector<Elem> MulNtt(std::span<const Elem> a,
+                                  std::span<const Elem> b, size_t result_size) {
+    auto convolution =
+        Ntt::Convolve(ToIntegers(a, a.size()), ToIntegers(b, b.size()),
+                      result_size);
+    return Trim(FromIntegers(convolution));
   }
 
+  // Returns coefficients of a (mod x^size - 1) as NTT input.
   [[nodiscard]]
-  static std::vector<Elem> MulNtt(const std::vector<Elem>& a,
-                                  const std::vector<Elem>& b,
-                                  size_t result_size) {
-    std::vector<uint64_t> first;
-    first.reserve(a.size());
-    for (const auto& value : a) {
-      first.push_back(value.Get()[0]);
+  static std::vector<uint64_t> ToIntegers(std::span<const Elem> a,
+                                          size_t size) {
+    std::vector<uint64_t> result(std::min(a.size(), size));
+    if (a.size() <= size) {
+      for (size_t i = 0; i < a.size(); ++i) {
+        result[i] = a[i].Get()[0];
+      }
+      return result;
     }
-
-    std::vector<uint64_t> second;
-    second.reserve(b.size());
-    for (const auto& value : b) {
-      second.push_back(value.Get()[0]);
+    std::vector<Elem> folded(a.begin(), a.begin() + size);
+    for (size_t i = size; i < a.size(); ++i) {
+      folded[i % size] += a[i];
     }
+    for (size_t i = 0; i < size; ++i) {
+      result[i] = folded[i].Get()[0];
+    }
+    return result;
+  }
 
-    auto convolution = detail::IntegerNtt<kNttMod, kNttGenerator>::Convolve(
-        std::move(first), std::move(second), result_size);
-
+  [[nodiscard]]
+  static std::vector<Elem> FromIntegers(const std::vector<uint64_t>& values) {
     std::vector<Elem> result;
-    result.reserve(result_size);
+    result.reserve(values.size());
     const uint64_t field_base = Elem::FieldBase();
-    for (const auto value : convolution) {
+    for (const auto value : values) {
       result.emplace_back(
           Elem(static_cast<typename Elem::Coefficient>(value % field_base)));
     }
-    while (!result.empty() && result.back() == Elem::Zero()) {
-      result.pop_back();
-    }
     return result;
   }
 
+  // Image of a (mod x^ntt_size - 1).
   [[nodiscard]]
-  static std::vector<Elem> Add(std::vector<Elem> a,
-                               const std::vector<Elem>& b) {
-    if (a.size() < b.size()) {
-      a.resize(b.size(), Elem::Zero());
-    }
-    for (size_t i = 0; i < b.size(); ++i) {
-      a[i] += b[i];
-    }
-    return Trim(std::move(a));
-  }
-
-  [[nodiscard]]
-  static std::vector<Elem> HalfGCDImpl(std::vector<Elem> a,
-                                       std::vector<Elem> b) {
-    if (a.size() == b.size()) {
-      if (a.empty()) {
-        return {};
-      }
-      b = Rem(std::move(b), a);
-    } else if (a.size() < b.size()) {
-      a.swap(b);
-    }
-
-    while (a.size() >= kHalfGCDThreshold && !b.empty()) {
-      HalfGCDReduce(a, b);
-      if (!b.empty()) {
-        a = Rem(std::move(a), b);
-        a.swap(b);
-      }
-    }
-    return PlainGCD(std::move(a), std::move(b));
-  }
-
-  static void HalfGCDReduce(std::vector<Elem>& u, std::vector<Elem>& v) {
-    const size_t d_red = u.size() / 2;
-    if (v.empty() || v.size() <= u.size() - d_red) {
-      return;
-    }
-
-    const size_t du = u.size() - 1;
-    size_t d1 = (d_red + 1) / 2;
-    d1 = std::max<size_t>(d1, 1);
-    if (d1 >= d_red) {
-      d1 = d_red - 1;
-    }
-
-    HalfGCDMatrix m1;
-    HalfGCD(m1, u, v, d1);
-    ApplyMatrix(u, v, m1);
-
-    const long d2 =
-        Degree(v) - static_cast<long>(du) + static_cast<long>(d_red);
-    if (v.empty() || d2 <= 0) {
-      return;
-    }
-
-    auto [quotient, remainder] = DivRem(u, v);
-    u = std::move(remainder);
-    u.swap(v);
-
-    HalfGCD(m1, u, v, static_cast<size_t>(d2));
-    ApplyMatrix(u, v, m1);
-  }
-
-  static void HalfGCD(HalfGCDMatrix& result, const std::vector<Elem>& u,
-                      const std::vector<Elem>& v, size_t d_red) {
-    if (v.empty() || v.size() <= u.size() - d_red) {
-      SetIdentity(result);
-      return;
-    }
-
-    const long shift = Degree(u) - 2 * static_cast<long>(d_red) + 2;
-    auto u1 = RightShift(u, shift > 0 ? static_cast<size_t>(shift) : 0);
-    auto v1 = RightShift(v, shift > 0 ? static_cast<size_t>(shift) : 0);
-
-    if (d_red <= kHalfGCDThreshold) {
-      IterHalfGCD(result, u1, v1, d_red);
-      return;
-    }
-
-    size_t d1 = (d_red + 1) / 2;
-    d1 = std::max<size_t>(d1, 1);
-    if (d1 >= d_red) {
-      d1 = d_red - 1;
-    }
-
-    HalfGCDMatrix m1;
-    HalfGCD(m1, u1, v1, d1);
-    ApplyMatrix(u1, v1, m1);
-
-    const long d2 = Degree(v1) - Degree(u) + shift + static_cast<long>(d_red);
-    if (v1.empty() || d2 <= 0) {
-      result = std::move(m1);
-      return;
-    }
-
-    auto [quotient, remainder] = DivRem(u1, v1);
-    u1 = std::move(remainder);
-    u1.swap(v1);
-
-    HalfGCDMatrix m2;
-    HalfGCD(m2, u1, v1, static_cast<size_t>(d2));
-    UpdateAfterDivision(m1, quotient);
-    result = MulMatrix(std::move(m2), std::move(m1));
-  }
-
-  static void IterHalfGCD(HalfGCDMatrix& result, std::vector<Elem>& u,
-                          std::vector<Elem>& v, size_t d_red) {
-    SetIdentity(result);
-    const size_t goal_size = u.size() - d_red;
-    if (v.size() <= goal_size) {
-      return;
-    }
-
-    while (v.size() > goal_size) {
-      auto [quotient, remainder] = DivRem(u, v);
-      u = std::move(remainder);
-      u.swap(v);
-      UpdateAfterDivision(result, quotient);
-    }
-  }
-
-  static void SetIdentity(HalfGCDMatrix& matrix) {
-    matrix.data[0][0] = {Elem::One()};
-    matrix.data[0][1] = {};
-    matrix.data[1][0] = {};
-    matrix.data[1][1] = {Elem::One()};
-  }
-
-  static void ApplyMatrix(std::vector<Elem>& u, std::vector<Elem>& v,
-                          const HalfGCDMatrix& matrix) {
-    auto new_u = AddProducts(matrix.data[0][0], u, matrix.data[0][1], v);
-    auto new_v = AddProducts(matrix.data[1][0], u, matrix.data[1][1], v);
-    u = std::move(new_u);
-    v = std::move(new_v);
-  }
-
-  [[nodiscard]]
-  static HalfGCDMatrix MulMatrix(HalfGCDMatrix lhs, HalfGCDMatrix rhs) {
-    return {{
-        {AddProducts(lhs.data[0][0], rhs.data[0][0], lhs.data[0][1],
-                     rhs.data[1][0]),
-         AddProducts(lhs.data[0][0], rhs.data[0][1], lhs.data[0][1],
-                     rhs.data[1][1])},
-        {AddProducts(lhs.data[1][0], rhs.data[0][0], lhs.data[1][1],
-                     rhs.data[1][0]),
-         AddProducts(lhs.data[1][0], rhs.data[0][1], lhs.data[1][1],
-                     rhs.data[1][1])},
-    }};
+  static std::vector<uint64_t> Image(std::span<const Elem> a,
+                                     size_t ntt_size) {
+    return Ntt::Transform(ToIntegers(a, ntt_size), ntt_size);
   }
 
+  // Image used by SubProduct to restore a remainder modulo polynomial.
   [[nodiscard]]
-  static std::vector<Elem> MulTerm(const std::vector<Elem>& lhs,
-                                   const std::vector<Elem>& rhs) {
-    if (lhs.empty() || rhs.empty()) {
-      return {};
-    }
-    if (lhs.size() == 1 && lhs[0] == Elem::One()) {
-      return rhs;
-    }
-    if (rhs.size() == 1 && rhs[0] == Elem::One()) {
-      return lhs;
-    }
-    return Mul(lhs, rhs);
+  static std::vector<uint64_t> PolynomialImage(
+      const std::vector<Elem>& polynomial) {
+    return Image(polynomial, Ntt::NttSize(polynomial.size() - 1));
   }
 
+  // Returns the first result_size coefficients of a * b (mod x^k - 1),
+  // where image is the image of b of size k.
   [[nodiscard]]
-  static std::vector<Elem> AddProducts(const std::vector<Elem>& a,
-                                       const std::vector<Elem>& b,
-                                       const std::vector<Elem>& c,
-                                       const std::vector<Elem>& d) {
-    auto first = MulTerm(a, b);
-    if (first.empty()) {
-      return MulTerm(c, d);
-    }
-    return Add(std::move(first), MulTerm(c, d));
-  }
-
-  static void UpdateAfterDivision(HalfGCDMatrix& matrix,
-                                  const std::vector<Elem>& quotient) {
-    auto top_left = std::move(matrix.data[1][0]);
-    auto bottom_left =
-        Sub(std::move(matrix.data[0][0]), MulByQuotient(quotient, top_left));
-    matrix.data[0][0] = std::move(top_left);
-    matrix.data[1][0] = std::move(bottom_left);
-
-    auto top_right = std::move(matrix.data[1][1]);
-    auto bottom_right =
-        Sub(std::move(matrix.data[0][1]), MulByQuotient(quotient, top_right));
-    matrix.data[0][1] = std::move(top_right);
-    matrix.data[1][1] = std::move(bottom_right);
+  static std::vector<Elem> MulImage(std::span<const Elem> a,
+                                    const std::vector<uint64_t>& image,
+                                    size_t result_size) {
+    const size_t ntt_size = image.size();
+    auto product = Ntt::Transform(ToIntegers(a, ntt_size), ntt_size);
+    Ntt::MulInPlace(product, image);
+    return FromIntegers(Ntt::InverseTransform(
+        std::move(product), std::min(result_size, ntt_size)));
   }
 
+  /*! @brief Computes a - quotient * b for the exact quotient of a by b.
+   *
+   *  The result is the remainder, so it has size less than b.size() = m.
+   *  Let k >= m - 1 be the size of image, the image of b (mod x^k - 1).
+   *  Then
+   *    a - quotient * b = remainder (mod x^k - 1),
+   *  and since the remainder is shorter than k, it is equal to
+   *    (a mod (x^k - 1)) - (quotient * b mod (x^k - 1))
+   *  restricted to the first m - 1 coefficients. This needs a transform of
+   *  size about m instead of quotient.size() + m.
+   */
   [[nodiscard]]
-  static std::vector<Elem> MulByQuotient(const std::vector<Elem>& quotient,
-                                         const std::vector<Elem>& value) {
-    if (quotient.size() > 4) {
-      return MulTerm(quotient, value);
-    }
-    if (quotient.empty() || value.empty()) {
-      return {};
-    }
-    if (quotient.size() == 1) {
-      if (quotient[0] == Elem::Zero()) {
-        return {};
-      }
-      if (quotient[0] == Elem::One()) {
-        return value;
-      }
-      std::vector<Elem> result(value);
-      for (auto& coeff : result) {
-        coeff *= quotient[0];
+  static std::vector<Elem> SubProduct(const std::vector<Elem>& a,
+                                      const std::vector<Elem>& quotient,
+                                      const std::vector<uint64_t>& image,
+                                      size_t m) {
+    const size_t ntt_size = image.size();
+    std::vector<Elem> remainder(m - 1, Elem::Zero());
+    for (size_t i = 0; i < a.size(); ++i) {
+      if (i % ntt_size < m - 1) {
+        remainder[i % ntt_size] += a[i];
       }
-      return Trim(std::move(result));
     }
-
-    std::vector<Elem> result(value.size() + quotient.size() - 1, Elem::Zero());
-    for (size_t i = 0; i < quotient.size(); ++i) {
-      if (quotient[i] == Elem::Zero()) [[unlikely]] {
-        continue;
-      }
-      for (size_t j = 0; j < value.size(); ++j) {
-        if (value[j] == Elem::Zero()) [[unlikely]] {
-          continue;
-        }
-        result[i + j] += quotient[i] * value[j];
+    if (!quotient.empty()) {
+      auto product = MulImage(quotient, image, m - 1);
+      for (size_t i = 0; i < product.size(); ++i) {
+        remainder[i] -= product[i];
       }
     }
-    return Trim(std::move(result));
+    return Trim(std::move(remainder));
   }
 
   [[nodiscard]]
-  static std::vector<Elem> RightShift(const std::vector<Elem>& a,
-                                      size_t shift) {
-    if (shift >= a.size()) {
-      return {};
-    }
-    return Trim(std::vector<Elem>(a.begin() + shift, a.end()));
-  }
-
-  [[nodiscard]]
-  static long Degree(const std::vector<Elem>& a) {
-    if (a.empty()) {
-      return -1;
-    }
-    return static_cast<long>(a.size() - 1);
+  static std::vector<Elem> SubProduct(const std::vector<Elem>& a,
+                                      const std::vector<Elem>& quotient,
+                                      const Modulus& modulus) {
+    if (modulus.polynomial_image.empty()) {
+      return SubProduct(a, quotient, PolynomialImage(modulus.polynomial),
+                        modulus.polynomial.size());
+    }
+    return SubProduct(a, quotient, modulus.polynomial_image,
+                      modulus.polynomial.size());
   }
 };
 
@@ -24,6 +24,7 @@
 
 #include <concepts>
 #include <cstddef>
+#include <span>
 #include <utility>
 #include <vector>
 
@@ -263,6 +264,15 @@ class PolynomialBase {
     return std::move(data_);
   }
 
+  // Coefficients without a copy, valid while the polynomial is unchanged
+  [[nodiscard]]
+  std::span<const Element> View() const& noexcept {
+    return data_;
+  }
+
+  // A view of a temporary would dangle as soon as the statement ends
+  std::span<const Element> View() const&& = delete;
+
   [[nodiscard]]
   size_t Size() const noexcept {
     return data_.size();
@@ -0,0 +1,106 @@
+// MIT License
+//
+// Copyright (c) 2026 Andrei Ishutin
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <factorization/concepts.hpp>
+
+namespace factorization::polynomial {
+
+/*! @brief Reference-counted immutable polynomial with copy-on-write.
+ *
+ *  Copies of a handle share one polynomial, so tables of large polynomials
+ *  can be passed between stages without duplicating them. The polynomial is
+ *  never changed while it is shared: Reduce makes a new version for this
+ *  handle only, and reuses the storage when the handle is the only owner.
+ *
+ *  Reading through several handles is safe from different threads. A handle
+ *  itself must not be copied and reduced concurrently.
+ */
+template <concepts::Polynom Poly>
+class SharedPolynomial {
+ public:
+  SharedPolynomial() = default;
+
+  explicit SharedPolynomial(Poly poly)
+      : data_(std::make_shared<Poly>(std::move(poly))) {
+  }
+
+  [[nodiscard]]
+  const Poly& Get() const {
+    static const Poly kZero;
+    return data_ ? *data_ : kZero;
+  }
+
+  [[nodiscard]]
+  const Poly& operator*() const {
+    return Get();
+  }
+
+  [[nodiscard]]
+  const Poly* operator->() const {
+    return &Get();
+  }
+
+  // Number of handles sharing the polynomial, zero for the default handle
+  [[nodiscard]]
+  long UseCount() const noexcept {
+    return data_.use_count();
+  }
+
+  /*! @brief Replaces the polynomial of this handle by its remainder.
+   *
+   *  modulus_size is the size of the polynomial of mod. Shorter polynomials
+   *  are already reduced and stay shared.
+   */
+  void Reduce(const typename Poly::Modulus& mod, size_t modulus_size) {
+    if (!data_ || data_->Size() < modulus_size) {
+      return;
+    }
+    if (data_.use_count() == 1) {
+      *data_ = std::move(*data_).Rem(mod);
+    } else {
+      data_ = std::make_shared<Poly>(data_->Rem(mod));
+    }
+  }
+
+ private:
+  std::shared_ptr<Poly> data_;
+};
+
+/*! @brief Moves every polynomial of a table into its own handle. */
+template <concepts::Polynom Poly>
+std::vector<SharedPolynomial<Poly>> Share(std::vector<Poly> polys) {
+  std::vector<SharedPolynomial<Poly>> result;
+  result.reserve(polys.size());
+  for (auto& poly : polys) {
+    result.emplace_back(std::move(poly));
+  }
+  return result;
+}
+
+}  // namespace factorization::polynomial
@@ -0,0 +1,164 @@
+// MIT License
+//
+// Copyright (c) 2026 Andrei Ishutin
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include <factorization/concepts.hpp>
+
+namespace factorization::polynomial {
+
+/*! @brief Division by a modulus with few nonzero terms, such as trinomials
+ *  x^n + x^k + 1 and pentanomials.
+ *
+ *  For f = f_n x^n + sum_e f_e x^e the reduction uses
+ *    x^n = -sum_e (f_e / f_n) x^e (mod f),
+ *  so each coefficient of the quotient costs one multiply-add per term
+ *  instead of a product with the dense inverse of f. Coefficients are
+ *  eliminated in runs of n - e_max, where e_max is the highest exponent of
+ *  the tail: a run only writes below itself, so every term is applied to
+ *  the whole run as one shifted multiply-add, which the compiler vectorizes.
+ *
+ *  Engines build it in BuildModulus and use it instead of the dense path
+ *  whenever it is not empty.
+ */
+template <concepts::GaloisFieldElement Elem>
+class SparseModulus {
+ public:
+  // At most this many nonzero terms below the leading one.
+  constexpr static size_t kMaxTerms = 8;
+
+  SparseModulus() = default;
+
+  // Empty if f is too dense: more than kMaxTerms terms in the tail, or more
+  // than a quarter of its degree.
+  explicit SparseModulus(const std::vector<Elem>& polynomial) {
+    if (polynomial.size() < 2) {
+      return;
+    }
+    const size_t degree = polynomial.size() - 1;
+    const Elem lead_inverse = polynomial.back().Inverse();
+    for (size_t e = 0; e < degree; ++e) {
+      if (polynomial[e] == Elem::Zero()) {
+        continue;
+      }
+      if (exponents_.size() == kMaxTerms ||
+          4 * (exponents_.size() + 1) > degree) {
+        exponents_.clear();
+        coefficients_.clear();
+        return;
+      }
+      exponents_.push_back(e);
+      coefficients_.push_back(-polynomial[e] * lead_inverse);
+    }
+    size_ = polynomial.size();
+    lead_inverse_ = lead_inverse;
+  }
+
+  [[nodiscard]]
+  bool Empty() const {
+    return size_ == 0;
+  }
+
+  // assume !Empty()
+  [[nodiscard]]
+  std::vector<Elem> Rem(std::vector<Elem> a) const {
+    Reduce(a, nullptr);
+    return a;
+  }
+
+  // assume !Empty()
+  [[nodiscard]]
+  std::pair<std::vector<Elem>, std::vector<Elem>> DivRem(
+      std::vector<Elem> a) const {
+    std::vector<Elem> quotient;
+    Reduce(a, &quotient);
+    return {std::move(quotient), std::move(a)};
+  }
+
+ private:
+  void Reduce(std::vector<Elem>& a, std::vector<Elem>* quotient) const {
+    const size_t degree = size_ - 1;
+    if (a.size() < size_) {
+      Trim(a);
+      return;
+    }
+    if (quotient != nullptr) {
+      quotient->assign(a.size() - degree, Elem::Zero());
+    }
+
+    // A run [from, top) writes to [from - n + e, top - n + e) for every
+    // exponent e of the tail, which is below from when the run is at most
+    // n - e_max long.
+    const size_t run =
+        exponents_.empty() ? a.size() : degree - exponents_.back();
+    size_t top = a.size();
+    while (top > degree) {
+      const size_t from = top - degree > run ? top - run : degree;
+      const size_t length = top - from;
+      const Elem* source = a.data() + from;
+      if (quotient != nullptr) {
+        for (size_t j = 0; j < length; ++j) {
+          (*quotient)[from - degree + j] = source[j] * lead_inverse_;
+        }
+      }
+      for (size_t i = 0; i < exponents_.size(); ++i) {
+        Elem* target = a.data() + from - degree + exponents_[i];
+        const Elem coefficient = coefficients_[i];
+        if (coefficient == Elem::One()) {
+          for (size_t j = 0; j < length; ++j) {
+            target[j] += source[j];
+          }
+        } else {
+          for (size_t j = 0; j < length; ++j) {
+            target[j] += coefficient * source[j];
+          }
+        }
+      }
+      top = from;
+    }
+    a.resize(degree);
+    Trim(a);
+    if (quotient != nullptr) {
+      Trim(*quotient);
+    }
+  }
+
+  static void Trim(std::vector<Elem>& a) {
+    while (!a.empty() && a.back() == Elem::Zero()) {
+      a.pop_back();
+    }
+  }
+
+  // Size of f, zero if the modulus is empty.
+  size_t size_ = 0;
+  // Tail of f as x^n = sum coefficients_[i] x^{exponents_[i]} (mod f),
+  // exponents in increasing order.
+  std::vector<size_t> exponents_;
+  std::vector<Elem> coefficients_;
+  Elem lead_inverse_;
+};
+
+}  // namespace factorization::polynomial
@@ -0,0 +1,263 @@
+// MIT License
+//
+// Copyright (c) 2026 Andrei Ishutin
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include <factorization/concepts.hpp>
+#include <factorization/runtime/parallel_for.hpp>
+
+namespace factorization::polynomial {
+
+/*! @brief Tree of products of x - a_i for multipoint evaluation and
+ *  interpolation.
+ *
+ *  Points are split into blocks of kLeafSize, a leaf holds the product of
+ *  x - a_i over its block and every inner node the product of its children,
+ *  so the root is the product over all points. Evaluation goes down the tree
+ *  by remainders and interpolation goes up by linear combinations, both take
+ *  O(M(n) log n) operations for products of cost M(n). Products and
+ *  remainders go through Engine.
+ *
+ *  If a scheduler is given, nodes of every level are processed in parallel.
+ *  The calls block until the level is done, so they must not run inside a
+ *  task of the same scheduler.
+ */
+template <concepts::GaloisFieldElement Elem,
+          concepts::PolynomialEngine<Elem> Engine>
+class SubproductTree {
+ public:
+  /*! @brief Builds the tree over points, which may contain duplicates unless
+   *  the tree is used for interpolation.
+   */
+  explicit SubproductTree(std::vector<Elem> points,
+                          runtime::IScheduler* scheduler = nullptr)
+      : points_(std::move(points)),
+        scheduler_(scheduler) {
+    if (points_.empty()) {
+      return;
+    }
+    levels_.emplace_back((points_.size() + kLeafSize - 1) / kLeafSize);
+    ForEach(levels_[0].size(), [&](size_t i) {
+      levels_[0][i] = LeafProduct(i);
+    });
+    while (levels_.back().size() > 1) {
+      const auto& level = levels_.back();
+      std::vector<std::vector<Elem>> next((level.size() + 1) / 2);
+      ForEach(next.size(), [&](size_t i) {
+        next[i] = 2 * i + 1 < level.size()
+                      ? Engine::Mul(level[2 * i], level[2 * i + 1])
+                      : level[2 * i];
+      });
+      levels_.push_back(std::move(next));
+    }
+  }
+
+  [[nodiscard]]
+  const std::vector<Elem>& Points() const {
+    return points_;
+  }
+
+  /*! @brief Returns the product of x - a_i over all points. */
+  [[nodiscard]]
+  std::vector<Elem> Root() const {
+    if (levels_.empty()) {
+      return {Elem::One()};
+    }
+    return levels_.back()[0];
+  }
+
+  /*! @brief Returns f(a_i) for every point a_i. */
+  [[nodiscard]]
+  std::vector<Elem> Evaluate(std::vector<Elem> f) const {
+    std::vector<Elem> result(points_.size(), Elem::Zero());
+    if (points_.empty()) {
+      return result;
+    }
+
+    std::vector<std::vector<Elem>> remainders(1);
+    remainders[0] = Reduce(std::move(f), levels_.back()[0]);
+    for (size_t level = levels_.size() - 1; level-- > 0;) {
+      const auto& nodes = levels_[level];
+      std::vector<std::vector<Elem>> next(nodes.size());
+      ForEach(nodes.size(), [&](size_t i) {
+        next[i] = Reduce(remainders[i / 2], nodes[i]);
+      });
+      remainders = std::move(next);
+    }
+
+    ForEach(remainders.size(), [&](size_t i) {
+      const size_t end = std::min(points_.size(), (i + 1) * kLeafSize);
+      for (size_t j = i * kLeafSize; j < end; ++j) {
+        result[j] = Horner(remainders[i], points_[j]);
+      }
+    });
+    return result;
+  }
+
+  /*! @brief Returns the polynomial of degree less than the number of points
+   *  taking values[i] at a_i.
+   *
+   *  Lagrange interpolation: with M the root and w_i = 1 / M'(a_i),
+   *    f = sum of values[i] w_i M / (x - a_i).
+   *  The weights take one evaluation, the sum is collected bottom-up:
+   *  a node gets left * M_right + right * M_left from its children.
+   *
+   *  @pre points are distinct and values.size() == Points().size().
+   */
+  [[nodiscard]]
+  std::vector<Elem> Interpolate(const std::vector<Elem>& values) const {
+    if (points_.empty()) {
+      return {};
+    }
+    auto weights = Evaluate(Derivative(levels_.back()[0]));
+    for (size_t i = 0; i < weights.size(); ++i) {
+      weights[i] = values[i] * weights[i].Inverse();
+    }
+
+    std::vector<std::vector<Elem>> sums(levels_[0].size());
+    ForEach(sums.size(), [&](size_t i) {
+      sums[i] = LeafSum(i, weights);
+    });
+    for (size_t level = 0; level + 1 < levels_.size(); ++level) {
+      const auto& nodes = levels_[level];
+      std::vector<std::vector<Elem>> next((nodes.size() + 1) / 2);
+      ForEach(next.size(), [&](size_t i) {
+        if (2 * i + 1 == nodes.size()) {
+          next[i] = std::move(sums[2 * i]);
+          return;
+        }
+        next[i] = Add(Engine::Mul(sums[2 * i], nodes[2 * i + 1]),
+                      Engine::Mul(sums[2 * i + 1], nodes[2 * i]));
+      });
+      sums = std::move(next);
+    }
+    return std::move(sums[0]);
+  }
+
+ private:
+  // Blocks of this many points are handled by quadratic methods.
+  constexpr static size_t kLeafSize = 16;
+
+  template <typename F>
+  void ForEach(size_t count, F&& body) const {
+    constexpr size_t kChunksPerLevel = 64;
+    runtime::ParallelFor(scheduler_, count, kChunksPerLevel,
+                         std::forward<F>(body));
+  }
+
+  static void TrimInPlace(std::vector<Elem>& a) {
+    while (!a.empty() && a.back() == Elem::Zero()) {
+      a.pop_back();
+    }
+  }
+
+  [[nodiscard]]
+  static std::vector<Elem> Add(std::vector<Elem> a,
+                               const std::vector<Elem>& b) {
+    if (a.size() < b.size()) {
+      a.resize(b.size(), Elem::Zero());
+    }
+    for (size_t i = 0; i < b.size(); ++i) {
+      a[i] += b[i];
+    }
+    TrimInPlace(a);
+    return a;
+  }
+
+  [[nodiscard]]
+  static std::vector<Elem> Reduce(std::vector<Elem> a,
+                                  const std::vector<Elem>& modulus) {
+    if (a.size() < modulus.size()) {
+      return a;
+    }
+    return Engine::Rem(std::move(a), modulus);
+  }
+
+  [[nodiscard]]
+  static std::vector<Elem> Derivative(const std::vector<Elem>& a) {
+    std::vector<Elem> result(a.size() - 1);
+    for (size_t i = 1; i < a.size(); ++i) {
+      result[i - 1] = Elem(i) * a[i];
+    }
+    TrimInPlace(result);
+    return result;
+  }
+
+  [[nodiscard]]
+  static Elem Horner(const std::vector<Elem>& a, const Elem& point) {
+    Elem result = Elem::Zero();
+    for (size_t i = a.size(); i-- > 0;) {
+      result = result * point + a[i];
+    }
+    return result;
+  }
+
+  // Multiplies a by x - point in place.
+  static void MulLinear(std::vector<Elem>& a, const Elem& point) {
+    a.push_back(Elem::Zero());
+    for (size_t i = a.size() - 1; i > 0; --i) {
+      a[i] = a[i - 1] - a[i] * point;
+    }
+    a[0] = -a[0] * point;
+  }
+
+  [[nodiscard]]
+  std::vector<Elem> LeafProduct(size_t leaf) const {
+    const size_t end = std::min(points_.size(), (leaf + 1) * kLeafSize);
+    std::vector<Elem> result{Elem::One()};
+    for (size_t j = leaf * kLeafSize; j < end; ++j) {
+      MulLinear(result, points_[j]);
+    }
+    return result;
+  }
+
+  // Sum of weights[j] * leaf / (x - a_j) over the points of the leaf.
+  [[nodiscard]]
+  std::vector<Elem> LeafSum(size_t leaf,
+                            const std::vector<Elem>& weights) const {
+    const auto& product = levels_[0][leaf];
+    std::vector<Elem> result(product.size() - 1, Elem::Zero());
+    const size_t end = std::min(points_.size(), (leaf + 1) * kLeafSize);
+    for (size_t j = leaf * kLeafSize; j < end; ++j) {
+      // Synthetic division of the leaf product by x - a_j.
+      Elem carry = Elem::Zero();
+      for (size_t i = product.size() - 1; i-- > 0;) {
+        carry = carry * points_[j] + product[i + 1];
+        result[i] += weights[j] * carry;
+      }
+    }
+    TrimInPlace(result);
+    return result;
+  }
+
+  std::vector<Elem> points_;
+  runtime::IScheduler* scheduler_;
+  // levels_[0] are the leaves, levels_.back() is the root.
+  std::vector<std::vector<std::vector<Elem>>> levels_;
+};
+
+}  // namespace factorization::polynomial
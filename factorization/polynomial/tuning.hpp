@@ -0,0 +1,111 @@
+// MIT License
+//
+// Copyright (c) 2026 Andrei Ishutin
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#include <factorization/concepts.hpp>
+
+#include "ntt_engine.hpp"
+
+namespace factorization::polynomial {
+
+/*! @brief Crossover points of HybridEngine, in numbers of coefficients.
+ *
+ *  Products are dispatched by the size of the shorter operand, divisions by
+ *  the sizes of the divisor and of the quotient.
+ */
+struct Thresholds {
+  constexpr static size_t kNever = std::numeric_limits<size_t>::max();
+
+  // Schoolbook products up to this size, Karatsuba above.
+  size_t karatsuba = 128;
+  // Prime fields: NTT products from this size.
+  size_t ntt = 128;
+  // Extension fields: NTT products of Kronecker substituted operands from
+  // this size.
+  size_t kronecker = kNever;
+  // Schoolbook division if the divisor or the quotient is at most this
+  // long, Newton division otherwise.
+  size_t plain_division = 128;
+  // Prime fields: Newton division with NTT products once both the divisor
+  // and the quotient have at least this size.
+  size_t ntt_division = 128;
+  // Parameters of HalfGcd: the size of reduction steps done by plain
+  // division and the size from which Gcd uses Half-GCD.
+  size_t half_gcd = 128;
+  size_t half_gcd_min = 32768;
+};
+
+/*! @brief Thresholds of this machine for GF(kFieldBase^kFieldPower).
+ *
+ *  Specializations with a kThresholds member are written by the autotune
+ *  benchmark into tuning_profile.hpp next to this file, see
+ *  benchmarks/autotune.cpp. Fields without a profile use the built-in
+ *  defaults. The profile is read by HybridEngine only, KaratsubaEngine and
+ *  NttEngine keep their own thresholds.
+ */
+template <uint64_t kFieldBase, size_t kFieldPower>
+struct MachineProfile {};
+
+}  // namespace factorization::polynomial
+
+#if __has_include("tuning_profile.hpp")
+#include "tuning_profile.hpp"
+#endif
+
+namespace factorization::polynomial {
+
+/*! @brief Thresholds measured on x86-64 for the fields of the tests.
+ *
+ *  NTT products overtake Karatsuba at about 128 coefficients for small prime
+ *  fields and at about 48 for primes above 2^16, whose multiplications are
+ *  more expensive. Kronecker substitution makes NTT operands 2k - 1 times
+ *  longer for GF(p^k), so it pays off only for the smallest extensions and
+ *  only at tens of thousands of coefficients.
+ */
+template <concepts::GaloisFieldElement Elem>
+constexpr inline Thresholds DefaultThresholds() {
+  using Profile = MachineProfile<Elem::FieldBase(), Elem::FieldPower()>;
+  if constexpr (requires { Profile::kThresholds; }) {
+    return Profile::kThresholds;
+  }
+
+  Thresholds result;
+  if constexpr (Elem::FieldPower() == 1) {
+    if (Elem::FieldBase() > (1 << 16)) {
+      result.ntt = 48;
+    }
+    if (NttEngine<Elem>::IsExact(result.ntt)) {
+      result.half_gcd = NttEngine<Elem>::kHalfGCDThreshold;
+      result.half_gcd_min = NttEngine<Elem>::kHalfGCDThreshold;
+    }
+  } else if (Elem::FieldPower() <= 3) {
+    result.kronecker = 16384;
+  }
+  return result;
+}
+
+}  // namespace factorization::polynomial
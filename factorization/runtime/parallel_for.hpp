@@ -0,0 +1,83 @@
+// MIT License
+//
+// Copyright (c) 2026 Andrei Ishutin
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <exception>
+#include <mutex>
+
+#include "thread_pool.hpp"
+#include "wait_group.hpp"
+
+namespace factorization::runtime {
+
+// Runs body(i) for every i in [0, count) and returns when all calls are done.
+// Calls go to the scheduler in at most `chunks` contiguous ranges, without a
+// scheduler they run on the calling thread in order.
+// A chunk stops at the first exception of body, the first exception of all
+// chunks is rethrown on the calling thread once every chunk has finished.
+// The caller blocks, so it must not be a task of the same scheduler.
+template <typename F>
+void ParallelFor(IScheduler* scheduler, size_t count, size_t chunks, F&& body) {
+  if (scheduler == nullptr || count <= 1 || chunks <= 1) {
+    for (size_t i = 0; i < count; ++i) {
+      body(i);
+    }
+    return;
+  }
+
+  chunks = chunks < count ? chunks : count;
+  WaitGroup wg;
+  std::mutex error_mutex;
+  std::exception_ptr error;
+  wg.Add(chunks);
+  for (size_t chunk = 0; chunk < chunks; ++chunk) {
+    const size_t begin = count * chunk / chunks;
+    const size_t end = count * (chunk + 1) / chunks;
+    SubmitTask(scheduler, [&body, &wg, &error_mutex, &error, begin, end] {
+      // Task::Run swallows exceptions, Done must not be skipped by them.
+      struct DoneGuard {
+        WaitGroup& wg;
+        ~DoneGuard() {
+          wg.Done();
+        }
+      } guard{wg};
+      try {
+        for (size_t i = begin; i < end; ++i) {
+          body(i);
+        }
+      } catch (...) {
+        std::unique_lock lock(error_mutex);
+        if (!error) {
+          error = std::current_exception();
+        }
+      }
+    });
+  }
+  wg.Wait();
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+}  // namespace factorization::runtime
@@ -23,10 +23,13 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
+#include <random>
 #include <utility>
 #include <vector>
 
 #include <factorization/concepts.hpp>
+#include <factorization/polynomial/common.hpp>
 #include <factorization/utils.hpp>
 
 #include "common.hpp"
@@ -45,22 +48,56 @@ class Berlekamp {
   using Element = typename Polynom::Element;
 
  public:
-  /*! @brief Factorizes a polynomial into irreducible factors with powers. */
-  inline std::vector<Factor<Polynom>> Factorize(Polynom polynom) const {
+  // Fields up to this size are split by trying every field element, larger
+  // ones by random elements of the Berlekamp subalgebra.
+  static constexpr uint64_t kEnumerationMaxField = 16;
+
+  /*! @brief Factorizes a polynomial into irreducible factors with powers.
+   *
+   *  random_gen is only used for fields larger than kEnumerationMaxField.
+   */
+  template <typename RandomGen>
+  inline std::vector<Factor<Polynom>> Factorize(Polynom polynom,
+                                                RandomGen& random_gen) const {
     std::vector<Factor<Polynom>> result;
     polynom = std::move(polynom).MakeMonic();
     if (polynom.IsZero() || polynom.IsOne()) {
       return {};
     }
     for (const auto& [sf_factor, power] : sff::SquareFreeFactorize(polynom)) {
-      for (const auto& factor : FactorizeImpl(sf_factor)) {
+      for (const auto& factor : FactorizeImpl(sf_factor, random_gen)) {
         result.emplace_back(factor, power);
       }
     }
     return result;
   }
 
+  /*! @brief Same as above with a default-seeded generator. */
+  inline std::vector<Factor<Polynom>> Factorize(Polynom polynom) const {
+    std::mt19937_64 random_gen;
+    return Factorize(std::move(polynom), random_gen);
+  }
+
+  /*! @brief Splits a monic square-free polynomial into irreducible factors.
+   *
+   *  This is Factorize without the square-free factorization, for callers
+   *  that have already done it.
+   */
+  template <typename RandomGen>
+  inline std::vector<Polynom> FactorizeSquareFree(Polynom polynom,
+                                                  RandomGen& random_gen) const {
+    return FactorizeImpl(std::move(polynom), random_gen);
+  }
+
+  /*! @brief Same as above with a default-seeded generator. */
+  inline std::vector<Polynom> FactorizeSquareFree(Polynom polynom) const {
+    std::mt19937_64 random_gen;
+    return FactorizeImpl(std::move(polynom), random_gen);
+  }
+
  private:
+  static constexpr uint64_t kFieldSize = utils::FieldSize<Element>();
+
   /*! @brief Splits a monic square-free polynomial into irreducible factors.
    *
    *  Input has the form
@@ -68,24 +105,40 @@ class Berlekamp {
    *  where all f_i are distinct irreducible factors.
    *
    *  An element b of the Berlekamp subalgebra is constant modulo every
-   *  f_i. Therefore, for each field element c, the polynomial
-   *    gcd(f, b - c)
-   *  collects exactly those irreducible factors f_i for which
-   *    b = c (mod f_i).
-   *  Applying this splitting to enough basis elements separates all f_i.
+   *  f_i. Small fields split f by this constant directly, see
+   *  SplitByEnumeration, larger ones by a random b, see SplitRandomly.
    */
-  inline std::vector<Polynom> FactorizeImpl(Polynom polynom) const {
+  template <typename RandomGen>
+  inline std::vector<Polynom> FactorizeImpl(Polynom polynom,
+                                            RandomGen& random_gen) const {
     std::vector<Polynom> basis = FindFactorizingBasis(polynom);
     // The basis size equals the number of irreducible factors. If it is one,
     // then f is irreducible.
     if (basis.size() == 1) {
       return {polynom};
     }
+    if constexpr (kFieldSize <= kEnumerationMaxField) {
+      return SplitByEnumeration(std::move(polynom), basis);
+    } else {
+      return SplitRandomly(std::move(polynom), basis, random_gen);
+    }
+  }
 
+  /*! @brief Splits f by every basis element and every field element.
+   *
+   *  For each field element c, the polynomial
+   *    gcd(f, b - c)
+   *  collects exactly those irreducible factors f_i for which
+   *    b = c (mod f_i).
+   *  Applying this splitting to enough basis elements separates all f_i.
+   *  Every basis element costs q gcds per factor.
+   */
+  inline std::vector<Polynom> SplitByEnumeration(
+      Polynom polynom, const std::vector<Polynom>& basis) const {
     const auto field_elements = Element::AllFieldElements();
     // factors is the current partition of f. Each nonconstant basis element
     // refines every part and writes the refined partition to new_factors.
-    std::vector<Polynom> factors = {polynom};
+    std::vector<Polynom> factors = {std::move(polynom)};
     std::vector<Polynom> new_factors;
     new_factors.reserve(basis.size());
 
@@ -115,6 +168,72 @@ class Berlekamp {
     return factors;
   }
 
+  /*! @brief Splits f by random elements of the Berlekamp subalgebra.
+   *
+   *  A random linear combination b of the basis takes independent random
+   *  values c_i = b (mod f_i) in GF(q). Every current factor g is split by
+   *    - gcd(g, b^((q - 1) / 2) - 1) for odd q, since c_i^((q - 1) / 2) is 1
+   *      for about half of the nonzero c_i and -1 or 0 otherwise;
+   *    - gcd(g, b + b^2 + ... + b^(2^(m - 1))) for q = 2^m, since the trace
+   *      of c_i is 0 or 1 with equal probability.
+   *  A factor with at least two irreducible divisors splits with probability
+   *  about 1/2 per round, and a round costs O(log q) modular products and
+   *  a gcd per factor instead of q gcds.
+   */
+  template <typename RandomGen>
+  inline std::vector<Polynom> SplitRandomly(Polynom polynom,
+                                            const std::vector<Polynom>& basis,
+                                            RandomGen& random_gen) const {
+    const size_t n = polynom.Size() - 1;
+    std::vector<Polynom> factors = {std::move(polynom)};
+    std::vector<Polynom> new_factors;
+    new_factors.reserve(basis.size());
+
+    while (factors.size() < basis.size()) {
+      std::vector<Element> combination(n, Element::Zero());
+      for (const auto& element : basis) {
+        const auto c = utils::RandomElement<Element>(random_gen);
+        const auto elems = element.View();
+        for (size_t i = 0; i < elems.size(); ++i) {
+          combination[i] += c * elems[i];
+        }
+      }
+      const Polynom b(std::move(combination));
+
+      for (auto& factor : factors) {
+        // Linear factors are irreducible.
+        if (factor.Size() <= 2) {
+          new_factors.emplace_back(std::move(factor));
+          continue;
+        }
+        const auto mod = factor.BuildModulus(2 * factor.Size());
+        Polynom residue = b.Rem(factor);
+        Polynom split;
+        if constexpr (Element::FieldBase() == 2) {
+          split = residue;
+          for (size_t i = 1; i < Element::FieldPower(); ++i) {
+            residue = std::move(residue).Sqr().Rem(mod);
+            split = std::move(split).Add(residue);
+          }
+        } else {
+          split = polynomial::BinPowMod(std::move(residue),
+                                        (kFieldSize - 1) / 2, mod)
+                      .Sub(Element::One());
+        }
+        Polynom divisor = factor.Gcd(split);
+        if (divisor.Size() > 1 && divisor.Size() < factor.Size()) {
+          new_factors.emplace_back(factor.Div(divisor).MakeMonic());
+          new_factors.emplace_back(std::move(divisor).MakeMonic());
+        } else {
+          new_factors.emplace_back(std::move(factor));
+        }
+      }
+      factors.swap(new_factors);
+      new_factors.clear();
+    }
+    return factors;
+  }
+
   /*! @brief Finds a basis of the Berlekamp subalgebra.
    *
    *  For an input polynomial f over GF(q), the subalgebra consists of
@@ -195,8 +314,6 @@ class Berlekamp {
    */
   inline std::vector<std::vector<Element>> BuildMatrix(
       const Polynom& factorizing) const {
-    constexpr int kFieldSize =
-        utils::BinPow(Element::FieldBase(), Element::FieldPower());
     size_t n = factorizing.Size() - 1;
     std::vector<std::vector<Element>> result(n, std::vector<Element>(n));
     // Rows of A are images of basis monomials:
@@ -205,21 +322,28 @@ class Berlekamp {
     //   ...
     //   A_{n-1} = x^{(n - 1) * q} (mod f)
     {
+      // Every row is reduced modulo f, so prepare the division once.
+      const auto mod = factorizing.BuildModulus(2 * factorizing.Size());
       // base = x^q (mod f).
       Polynom base;
       Polynom current(Element::One());
-      {
+      if constexpr (kFieldSize <= kEnumerationMaxField) {
         // Construct x^q directly and reduce it modulo f.
         std::vector<Element> tmp(kFieldSize + 1);
         tmp.back() = Element::One();  // the only nonzero element is last
         base = Polynom(std::move(tmp)).Rem(factorizing);
+      } else {
+        // x^q has q + 1 coefficients, so raise x to the q-th power modulo f
+        // instead.
+        Polynom x(std::vector<Element>{Element::Zero(), Element::One()});
+        base = polynomial::FrobeniusMod(std::move(x).Rem(factorizing), mod);
       }
       for (size_t power = 0; power < n; ++power) {
-        auto elems = current.Get();
+        const auto elems = current.View();
         for (size_t i = 0; i < elems.size(); ++i) {
           result[power][i] = elems[i];
         }
-        current = std::move(current).Mul(base).Rem(factorizing);
+        current = std::move(current).Mul(base).Rem(mod);
       }
     }
     // Convert A to (A - I)^T in place.
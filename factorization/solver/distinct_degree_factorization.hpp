@@ -33,6 +33,7 @@
 
 #include <factorization/concepts.hpp>
 #include <factorization/polynomial/common.hpp>
+#include <factorization/polynomial/shared_polynomial.hpp>
 #include <factorization/utils.hpp>
 
 /*! @file
@@ -82,6 +83,36 @@ struct DistinctDegreeFactor {
   int degree;
 };
 
+/*! @brief Frobenius powers of x computed by a baby-step/giant-step DDF.
+ *
+ *  Entries are reduced modulo the DDF input f:
+ *    baby_steps[i] = x^(q^i) (mod f) for 0 <= i <= l,
+ *    giant_steps[j] = x^(q^(j*l)) (mod f) for 1 <= j <= m,
+ *  where l is interval_size. After a reduction they stay valid modulo every
+ *  divisor of f, so equal-degree factorization of DDF components can reuse
+ *  them, see edf::EqualDegreeFactorize.
+ */
+template <concepts::Polynom Polynom>
+struct FrobeniusTable {
+  std::vector<polynomial::SharedPolynomial<Polynom>> baby_steps;
+  //!< giant_steps[0] is never used.
+  std::vector<polynomial::SharedPolynomial<Polynom>> giant_steps;
+  int interval_size = 1;
+
+  /*! @brief Returns x^(q^k) (mod f) if it is stored, nullptr otherwise. */
+  [[nodiscard]]
+  const Polynom* Find(int k) const {
+    if (k >= 0 && static_cast<size_t>(k) < baby_steps.size()) {
+      return &*baby_steps[k];
+    }
+    if (k > 0 && k % interval_size == 0 &&
+        static_cast<size_t>(k / interval_size) < giant_steps.size()) {
+      return &*giant_steps[k / interval_size];
+    }
+    return nullptr;
+  }
+};
+
 namespace naive {
 
 /*! @brief Straightforward reference implementation.
@@ -94,8 +125,6 @@ namespace naive {
 template <concepts::Polynom Poly>
 std::vector<DistinctDegreeFactor<Poly>> DistinctDegreeFactorize(Poly poly) {
   using Element = typename Poly::Element;
-  constexpr static auto kFieldSize =
-      utils::BinPow(Element::FieldBase(), Element::FieldPower());
 
   poly = std::move(poly).MakeMonic();
   if (poly.IsZero() || poly.IsOne()) {
@@ -114,7 +143,7 @@ std::vector<DistinctDegreeFactor<Poly>> DistinctDegreeFactorize(Poly poly) {
   // At the beginning of iteration `degree`, poly contains only irreducible
   // factors of degree at least `degree`.
   while (2 * degree <= poly.Size() - 1) {
-    h = polynomial::BinPowMod(std::move(h), kFieldSize, mod);
+    h = polynomial::FrobeniusMod(std::move(h), mod);
     Poly factor = poly.Gcd(h.Sub(x));
     // Extract all irreducible factors of degree `degree`.
     if (!factor.IsOne()) {
@@ -124,7 +153,7 @@ std::vector<DistinctDegreeFactor<Poly>> DistinctDegreeFactorize(Poly poly) {
       if (poly.IsOne()) {
         break;
       }
-      mod = poly.BuildModulus(2 * poly.Size());
+      mod = polynomial::RebuildModulus(poly, mod, factor, 2 * poly.Size());
       h = std::move(h).Rem(mod);
     }
     ++degree;
@@ -193,6 +222,8 @@ namespace ntl_like {
  *    auto factors = factorizer.Run();
  *  @endcode
  *
+ *  The baby and giant steps stay available after Run, see Frobenius.
+ *
  *  @see https://www.shoup.net/papers/factorimpl.pdf
  *  @see https://libntl.org/doc/GF2EXFactoring.cpp.html
  */
@@ -200,6 +231,7 @@ template <concepts::Polynom Poly, StepsMode kMode = kSmallField>
 class DistinctDegreeFactorizer {
   using Element = typename Poly::Element;
   using Modulus = typename Poly::Modulus;
+  using SharedPoly = polynomial::SharedPolynomial<Poly>;
   static constexpr auto kFieldSize =
       utils::BinPow(Element::FieldBase(), Element::FieldPower());
 
@@ -244,12 +276,12 @@ class DistinctDegreeFactorizer {
 
     /*! @brief Processes buffered products and clears the buffer.
      *
-     *  Returns true if a nontrivial factor was extracted from poly.
+     *  Returns the factor extracted from poly, which is one if there is none.
      *  Extracted interval components are written to F.
      */
-    bool Proceed(Poly& poly, std::vector<Poly>& F, const Modulus& mod) {
+    Poly Proceed(Poly& poly, std::vector<Poly>& F, const Modulus& mod) {
       if (Empty()) {
-        return false;
+        return Poly(Element::One());
       }
       // First test the product of all buffered intervals with one gcd.
       Poly product = buf_[0].second;
@@ -259,10 +291,11 @@ class DistinctDegreeFactorizer {
       product = std::move(product).Gcd(poly);
       if (product.IsOne()) {
         size_ = 0;
-        return false;
+        return product;
       }
 
       poly = std::move(poly).Div(product).MakeMonic();
+      Poly extracted = product;
       int i = 0;
       int j = buf_[0].first;
       int min_degree = (j - 1) * interval_size_ + 1;
@@ -287,7 +320,7 @@ class DistinctDegreeFactorizer {
       }
 
       size_ = 0;
-      return true;
+      return extracted;
     }
 
    private:
@@ -300,6 +333,15 @@ class DistinctDegreeFactorizer {
   explicit DistinctDegreeFactorizer(Poly poly)
       : poly_(std::move(poly)) {
     n = Degree(this->poly_);
+    l = BabyStepCount(n);
+    // ceil(n / (2 * l)):
+    m = (n + 2 * l - 1) / (2 * l);
+  }
+
+  /*! @brief Returns the number of baby steps l for a polynomial of degree n.
+   */
+  static int BabyStepCount(int n) {
+    int l = 0;
     if constexpr (kMode == kExactNtl) {
       // Classical NTL choice:
       // split degrees up to n / 2 into intervals of length
@@ -311,11 +353,7 @@ class DistinctDegreeFactorizer {
       // q-th power (mod f) is cheaper than modular composition.
       l = std::floor(std::pow(n, 0.75L) / std::sqrt(3.0L * std::log2(q)));
     }
-    if (l == 0) {
-      l = 1;
-    }
-    // ceil(n / (2 * l)):
-    m = (n + 2 * l - 1) / (2 * l);
+    return l == 0 ? 1 : l;
   }
 
   /*! @brief Runs all stages and returns DDF components. */
@@ -323,11 +361,20 @@ class DistinctDegreeFactorizer {
     auto mod = poly_.BuildModulus(2 * poly_.Size());
     GenerateBabySteps(mod);
     GenerateGiantSteps(mod);
-    GiantRefine();
+    GiantRefine(std::move(mod));
     BabyRefine();
     return std::move(result_);
   }
 
+  /*! @brief Returns the baby and giant steps of the last Run.
+   *
+   *  The table shares the polynomials with the factorizer.
+   */
+  [[nodiscard]]
+  FrobeniusTable<Poly> Frobenius() const {
+    return {h, H, l};
+  }
+
  private:
   /*! @brief Builds the baby-step table.
    *
@@ -341,12 +388,12 @@ class DistinctDegreeFactorizer {
   void GenerateBabySteps(const Modulus& mod) {
     const Poly x(std::vector<Element>{Element::Zero(), Element::One()});
 
-    h.resize(l + 1);
-    h[0] = x;
-    h[1] = polynomial::BinPowMod(x, kFieldSize, mod);
+    std::vector<Poly> table(l + 1);
+    table[0] = x;
+    table[1] = polynomial::FrobeniusMod(x, mod);
 
     // The NTL choice advances the table by modular composition.
-    // The small-field mode uses binary exponentiation to the q-th power.
+    // The small-field mode raises to the q-th power by FrobeniusMod.
     if constexpr (kMode == kExactNtl) {
       // Brent-Kung modular composition uses
       //   t ~= sqrt(n)
@@ -356,15 +403,13 @@ class DistinctDegreeFactorizer {
       if (t == 0) {
         t = 1;
       }
-      auto matrix = polynomial::BuildCompModMatrix(h[1], t, mod);
-      for (size_t i = 2; i <= l; ++i) {
-        h[i] = polynomial::CompMod(h[i - 1], matrix, mod);
-      }
+      polynomial::ComposeIterates(table, l, t, mod);
     } else {
       for (size_t i = 2; i <= l; ++i) {
-        h[i] = polynomial::BinPowMod(h[i - 1], kFieldSize, mod);
+        table[i] = polynomial::FrobeniusMod(table[i - 1], mod);
       }
     }
+    h = polynomial::Share(std::move(table));
   }
 
   /*! @brief Builds the giant-step table.
@@ -378,8 +423,8 @@ class DistinctDegreeFactorizer {
    */
   void GenerateGiantSteps(const Modulus& mod) {
     // H[0] is never used.
-    H.resize(m + 1);
-    H[1] = h[l];
+    std::vector<Poly> table(m + 1);
+    table[1] = *h[l];
 
     // Brent-Kung modular composition uses
     //   t ~= sqrt(n)
@@ -389,12 +434,12 @@ class DistinctDegreeFactorizer {
     if (t == 0) {
       t = 1;
     }
-    auto matrix = polynomial::BuildCompModMatrix(H[1], t, mod);
-    for (int j = 2; j <= m; ++j) {
-      // Advance by modular composition:
-      //   H[j] = H[j - 1](H[1]) (mod f).
-      H[j] = polynomial::CompMod(H[j - 1], matrix, mod);
-    }
+    // Advance by modular composition:
+    //   H[j] = H[j - 1](H[1]) (mod f).
+    polynomial::ComposeIterates(table, m, t, mod);
+    H = polynomial::Share(std::move(table));
+    // H[1] and h[l] are the same polynomial.
+    H[1] = h[l];
   }
 
   /*! @brief Fills F with nontrivial degree intervals.
@@ -406,37 +451,43 @@ class DistinctDegreeFactorizer {
    *  If a single large component remains after interval tests,
    *  it is appended directly to result_.
    *  After this stage Run no longer uses poly_.
+   *
+   *  mod is the modulus of poly_ used by the previous stages.
    */
-  void GiantRefine() {
+  void GiantRefine(Modulus mod) {
     // F[0] is never used.
     F.assign(m + 1, Poly(Element::One()));
     // h was built modulo the original polynomial.
     // hh is reduced whenever the current polynomial poly_ shrinks.
-    // h itself must stay unchanged because BabyRefine uses it later.
-    std::vector<Poly> hh = h;
+    // h itself must stay unchanged because BabyRefine uses it later. hh
+    // shares the polynomials of h until an entry is reduced.
+    std::vector<SharedPoly> hh = h;
 
-    Modulus mod = poly_.BuildModulus(2 * poly_.Size());
     GcdBuffer buffer(l);
     // At the beginning of interval j, poly_ contains only irreducible
     // factors with degrees greater than (j - 1)l.
     for (int j = 1; j <= m; ++j) {
-      Poly HH = H[j].Rem(mod);  // NOLINT(readability-identifier-naming)
+      Poly HH = H[j]->Rem(mod);  // NOLINT(readability-identifier-naming)
       // Interval product:
       //   I = product_{0 <= i < l}(H[j] - h[i]) (mod poly_).
-      Poly I = HH.Sub(hh[0]);  // NOLINT(readability-identifier-naming)
+      Poly I = HH.Sub(*hh[0]);  // NOLINT(readability-identifier-naming)
       for (int i = 1; i < l; ++i) {
-        I = std::move(I).Mul(HH.Sub(hh[i])).Rem(mod);
+        I = std::move(I).Mul(HH.Sub(*hh[i])).Rem(mod);
       }
       // The buffer batches several interval products and extracts their gcd
       // with poly_ in one call.
       // This happens at the very end or when buffer capacity is reached.
       buffer.Add(j, std::move(I));
-      if (buffer.Full() && buffer.Proceed(poly_, F, mod)) {
-        if (!poly_.IsOne() && Degree(poly_) >= 2 * j * l) {
+      if (buffer.Full()) {
+        const Poly extracted = buffer.Proceed(poly_, F, mod);
+        if (!extracted.IsOne() && !poly_.IsOne() &&
+            Degree(poly_) >= 2 * j * l) {
           // poly_ has changed, so modular reductions must use a new modulus.
-          mod = poly_.BuildModulus(2 * poly_.Size());
+          // It is derived from the old one, poly_ lost exactly extracted.
+          mod = polynomial::RebuildModulus(poly_, mod, extracted,
+                                           2 * poly_.Size());
           for (int i = 1; i <= l; ++i) {
-            hh[i] = std::move(hh[i]).Rem(mod);
+            hh[i].Reduce(mod, poly_.Size());
           }
         }
       }
@@ -491,10 +542,10 @@ class DistinctDegreeFactorizer {
       }
       // Degree test:
       //   gcd(H[j] - h[i], F_j) = gcd((H[j] - h[i]) (mod F_j), F_j).
-      Poly factor = H[j].Sub(h[i]).Rem(mod).Gcd(F_j);
+      Poly factor = H[j]->Sub(*h[i]).Rem(mod).Gcd(F_j);
       if (!factor.IsOne()) {
         F_j = std::move(F_j).Div(factor).MakeMonic();
-        mod = F_j.BuildModulus(n);
+        mod = polynomial::RebuildModulus(F_j, mod, factor, n);
         result_.emplace_back(std::move(factor), factor_degree);
       }
     }
@@ -504,9 +555,9 @@ class DistinctDegreeFactorizer {
   int n = 0;            // NOLINT(readability-identifier-naming)
   int l = 1;            // NOLINT(readability-identifier-naming)
   int m = 1;            // NOLINT(readability-identifier-naming)
-  std::vector<Poly> h;  // NOLINT(readability-identifier-naming)
-  std::vector<Poly> H;  // NOLINT(readability-identifier-naming)
-  std::vector<Poly> F;  // NOLINT(readability-identifier-naming)
+  std::vector<SharedPoly> h;  // NOLINT(readability-identifier-naming)
+  std::vector<SharedPoly> H;  // NOLINT(readability-identifier-naming)
+  std::vector<Poly> F;        // NOLINT(readability-identifier-naming)
   std::vector<DistinctDegreeFactor<Poly>> result_;
 };
 
@@ -605,7 +656,7 @@ class DistinctDegreeFactorizer {
       bool is_one = F.IsOne();
       if (!is_one) {
         poly_ = std::move(poly_).Div(F).MakeMonic();
-        IntervalRefine(j, std::move(F), H);
+        IntervalRefine(j, F, H);
       }
       // If
       //   deg(poly_) < 2jl,
@@ -619,7 +670,7 @@ class DistinctDegreeFactorizer {
         // Since deg(poly_) decreases, the modulus changes.
         // The Brent-Kung block size t is recomputed,
         // and the composition matrix must be updated accordingly.
-        mod = poly_.BuildModulus(2 * poly_.Size());
+        mod = polynomial::RebuildModulus(poly_, mod, F, 2 * poly_.Size());
         t = std::floor(std::sqrt(Degree(poly_)));
         t = std::max(t, 1);
         polynomial::UpdateCompModMatrix<Poly>(matrix, t, mod);
@@ -648,20 +699,17 @@ class DistinctDegreeFactorizer {
 
     h.resize(l + 1);
     h[0] = x;
-    h[1] = polynomial::BinPowMod(x, kFieldSize, mod);
+    h[1] = polynomial::FrobeniusMod(x, mod);
 
     if constexpr (kMode == kExactNtl) {
       int t = std::floor(std::sqrt(n));
       if (t == 0) {
         t = 1;
       }
-      auto matrix = polynomial::BuildCompModMatrix(h[1], t, mod);
-      for (size_t i = 2; i <= l; ++i) {
-        h[i] = polynomial::CompMod(h[i - 1], matrix, mod);
-      }
+      polynomial::ComposeIterates(h, l, t, mod);
     } else {
       for (size_t i = 2; i <= l; ++i) {
-        h[i] = polynomial::BinPowMod(h[i - 1], kFieldSize, mod);
+        h[i] = polynomial::FrobeniusMod(h[i - 1], mod);
       }
     }
   }
@@ -688,7 +736,7 @@ class DistinctDegreeFactorizer {
       Poly factor = H.Sub(h[i]).Rem(mod).Gcd(F);
       if (!factor.IsOne()) {
         F = std::move(F).Div(factor).MakeMonic();
-        mod = F.BuildModulus(n);
+        mod = polynomial::RebuildModulus(F, mod, factor, n);
         result_.emplace_back(std::move(factor), factor_degree);
       }
     }
@@ -732,6 +780,7 @@ template <concepts::Polynom Poly, StepsMode kMode = kSmallField>
 class DistinctDegreeFactorizer {
   using Element = typename Poly::Element;
   using Modulus = typename Poly::Modulus;
+  using SharedPoly = polynomial::SharedPolynomial<Poly>;
   static constexpr auto kFieldSize =
       utils::BinPow(Element::FieldBase(), Element::FieldPower());
 
@@ -921,64 +970,73 @@ class DistinctDegreeFactorizer {
     Modulus mod = poly_.BuildModulus(2 * poly_.Size());
     GenerateBabySteps(mod);
     GenerateGiantSteps(mod);
-    GiantRefine();
+    GiantRefine(std::move(mod));
     BabyRefine();
     return std::move(result_);
   }
 
+  /*! @brief Returns the baby and giant steps of the last Run.
+   *
+   *  The table shares the polynomials with the factorizer.
+   */
+  [[nodiscard]]
+  FrobeniusTable<Poly> Frobenius() const {
+    return {h, H, l};
+  }
+
  private:
   void GenerateBabySteps(const Modulus& mod) {
     const Poly x(std::vector<Element>{Element::Zero(), Element::One()});
 
-    h.resize(l + 1);
-    h[0] = x;
-    h[1] = polynomial::BinPowMod(x, kFieldSize, mod);
+    std::vector<Poly> table(l + 1);
+    table[0] = x;
+    table[1] = polynomial::FrobeniusMod(x, mod);
 
     if constexpr (kMode == kExactNtl) {
       int t = std::floor(std::sqrt(n));
       if (t == 0) {
         t = 1;
       }
-      auto matrix = polynomial::BuildCompModMatrix(h[1], t, mod);
-      for (size_t i = 2; i <= l; ++i) {
-        h[i] = polynomial::CompMod(h[i - 1], matrix, mod);
-      }
+      polynomial::ComposeIterates(table, l, t, mod);
     } else {
       for (size_t i = 2; i <= l; ++i) {
-        h[i] = polynomial::BinPowMod(h[i - 1], kFieldSize, mod);
+        table[i] = polynomial::FrobeniusMod(table[i - 1], mod);
       }
     }
+    h = polynomial::Share(std::move(table));
   }
 
   void GenerateGiantSteps(const Modulus& mod) {
     // H[0] is never used
-    H.resize(m + 1);
-    H[1] = h[l];
+    std::vector<Poly> table(m + 1);
+    table[1] = *h[l];
 
     int t = std::floor(std::sqrt(n));
     if (t == 0) {
       t = 1;
     }
-    auto matrix = polynomial::BuildCompModMatrix(H[1], t, mod);
-    for (int j = 2; j <= m; ++j) {
-      // Advance by modular composition:
-      //   H[j] = H[j - 1](H[1]) (mod f).
-      H[j] = polynomial::CompMod(H[j - 1], matrix, mod);
-    }
+    // Advance by modular composition:
+    //   H[j] = H[j - 1](H[1]) (mod f).
+    polynomial::ComposeIterates(table, m, t, mod);
+    H = polynomial::Share(std::move(table));
+    // H[1] and h[l] are the same polynomial.
+    H[1] = h[l];
   }
 
-  /*! @brief Fills F with nontrivial degree intervals using ComputationTree. */
-  void GiantRefine() {
+  /*! @brief Fills F with nontrivial degree intervals using ComputationTree.
+   *
+   *  mod is the modulus of poly_ used by the previous stages.
+   */
+  void GiantRefine(Modulus mod) {
     // F[0] is never used.
     F.assign(m + 1, Poly(Element::One()));
-    Modulus mod = poly_.BuildModulus(2 * poly_.Size());
     ComputationTree tree(l, m, mod);
     for (int j = 1; j <= m; ++j) {
       // Interval product:
       //   I[j] = product_{0 <= i < l}(H[j] - h[i]) (mod poly_).
-      Poly I = H[j].Sub(h[0]);  // NOLINT(readability-identifier-naming)
+      Poly I = H[j]->Sub(*h[0]);  // NOLINT(readability-identifier-naming)
       for (int i = 1; i < l; ++i) {
-        I = std::move(I).Mul(H[j].Sub(h[i])).Rem(mod);
+        I = std::move(I).Mul(H[j]->Sub(*h[i])).Rem(mod);
       }
       tree.Add(j, std::move(I));
     }
@@ -1022,10 +1080,10 @@ class DistinctDegreeFactorizer {
       }
       // factor = Gcd(H_j - h_i, F_j)
       // but since deg F_j is low we use rem first
-      Poly factor = H[j].Sub(h[i]).Rem(mod).Gcd(F_j);
+      Poly factor = H[j]->Sub(*h[i]).Rem(mod).Gcd(F_j);
       if (!factor.IsOne()) {
         F_j = std::move(F_j).Div(factor).MakeMonic();
-        mod = F_j.BuildModulus(n);
+        mod = polynomial::RebuildModulus(F_j, mod, factor, n);
         result_.emplace_back(std::move(factor), factor_degree);
       }
     }
@@ -1035,9 +1093,9 @@ class DistinctDegreeFactorizer {
   int n = 0;            // NOLINT(readability-identifier-naming)
   int l = 1;            // NOLINT(readability-identifier-naming)
   int m = 1;            // NOLINT(readability-identifier-naming)
-  std::vector<Poly> h;  // NOLINT(readability-identifier-naming)
-  std::vector<Poly> H;  // NOLINT(readability-identifier-naming)
-  std::vector<Poly> F;  // NOLINT(readability-identifier-naming)
+  std::vector<SharedPoly> h;  // NOLINT(readability-identifier-naming)
+  std::vector<SharedPoly> H;  // NOLINT(readability-identifier-naming)
+  std::vector<Poly> F;        // NOLINT(readability-identifier-naming)
   std::vector<DistinctDegreeFactor<Poly>> result_;
 };
 
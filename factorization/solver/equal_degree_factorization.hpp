@@ -0,0 +1,308 @@
+// MIT License
+//
+// Copyright (c) 2026 Andrei Ishutin
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <factorization/concepts.hpp>
+#include <factorization/polynomial/common.hpp>
+#include <factorization/solver/distinct_degree_factorization.hpp>
+#include <factorization/utils.hpp>
+
+/*! @file
+ *  @brief Equal-degree factorization (Cantor-Zassenhaus) over GF(q).
+ *
+ *  The input f is a product of r distinct monic irreducible factors of degree
+ *  d, as produced by DDF. For a random a of degree less than deg f the
+ *  residues of a modulo the factors are independent random elements of
+ *  GF(q^d), so
+ *    - for odd q, a^((q^d - 1) / 2) = 1 modulo about half of the factors, and
+ *      gcd(f, a^((q^d - 1) / 2) - 1) is a proper divisor of f with probability
+ *      at least 1 - 2^(1 - r);
+ *    - for q = 2^m, the absolute trace
+ *        Tr(a) = a + a^2 + ... + a^(2^(md - 1))
+ *      takes values 0 and 1 only, so gcd(f, Tr(a)) does the same.
+ *
+ *  Both maps are built from the Frobenius powers a, a^q, ..., a^(q^(d-1)):
+ *    a^((q^d - 1) / 2) = c c^q ... c^(q^(d-1)),  c = a^((q - 1) / 2),
+ *    Tr(a) = u + u^2 + ... + u^(2^(m-1)),  u = a + a^q + ... + a^(q^(d-1)).
+ *  Since a^(q^i) = a(x^(q^i)) (mod f), the folds take O(log d) modular
+ *  compositions by doubling instead of d exponentiations by q.
+ *
+ *  @code
+ *    for (const auto& [factor, degree] : ddf::DistinctDegreeFactorize(poly)) {
+ *      auto irreducibles =
+ *          factorization::edf::EqualDegreeFactorize(factor, degree);
+ *    }
+ *  @endcode
+ */
+
+namespace factorization::edf {
+
+namespace detail {
+
+template <concepts::Polynom Poly>
+using Element = typename Poly::Element;
+
+/*! @brief Returns a (+) a^q (+) ... (+) a^(q^(degree-1)) (mod f), where (+) is
+ *  combine.
+ *
+ *  Let s_k be the fold of the first k terms and X_k = x^(q^k) (mod f). Then
+ *    s_2k = s_k (+) s_k(X_k),   X_2k = X_k(X_k),
+ *    s_k+1 = a (+) s_k(X_1),    X_k+1 = X_k(X_1),
+ *  and both compositions of a step share the power table of their argument.
+ *  lookup(k) may return a known X_k, e.g. from the DDF tables, and then only
+ *  s is composed. The last X_k is never needed.
+ *
+ *  @pre a and xq = x^q are already reduced modulo mod.
+ *  @pre degree > 0.
+ */
+template <concepts::Polynom Poly, typename Combine, typename Lookup>
+Poly FrobeniusFold(const Poly& a, const Poly& xq, int degree,
+                   const typename Poly::Modulus& mod, Combine combine,
+                   Lookup lookup) {
+  using Matrix = std::vector<std::vector<Element<Poly>>>;
+
+  const size_t t = std::max<size_t>(1, std::floor(std::sqrt(xq.Size())));
+  const Matrix xq_matrix = polynomial::BuildCompModMatrix(xq, t, mod);
+
+  Poly fold = a;
+  Poly frobenius = xq;
+  // Returns s_k(X), where matrix is the power table of X, and moves frobenius
+  // from X_k to X_next if it is needed.
+  auto compose = [&](const Matrix& matrix, int next, bool needed) {
+    std::optional<Poly> known;
+    if (needed) {
+      known = lookup(next);
+    }
+    if (!needed || known) {
+      if (known) {
+        frobenius = std::move(*known);
+      }
+      return polynomial::CompMod(fold, matrix, mod);
+    }
+    auto composed = polynomial::CompModMany(std::vector<Poly>{fold, frobenius},
+                                            matrix, mod);
+    frobenius = std::move(composed[1]);
+    return std::move(composed[0]);
+  };
+
+  int bit = 0;
+  while ((degree >> (bit + 1)) != 0) {
+    ++bit;
+  }
+  int k = 1;
+  while (bit-- > 0) {
+    const bool increment = (degree >> bit) % 2 != 0;
+    Matrix matrix;
+    if (k > 1) {
+      matrix = polynomial::BuildCompModMatrix(frobenius, t, mod);
+    }
+    fold = combine(fold, compose(k > 1 ? matrix : xq_matrix, 2 * k, bit > 0));
+    k *= 2;
+    if (increment) {
+      fold = combine(a, compose(xq_matrix, k + 1, bit > 0));
+      ++k;
+    }
+  }
+  return fold;
+}
+
+// Returns a polynomial whose gcd with f is a random divisor of f.
+template <concepts::Polynom Poly, typename RandomGen, typename Lookup>
+Poly SplittingPolynomial(const Poly& xq, int degree,
+                         const typename Poly::Modulus& mod, size_t size,
+                         RandomGen& random_gen, Lookup lookup) {
+  using Elem = Element<Poly>;
+
+  std::vector<Elem> coefficients(size - 1);
+  for (auto& coefficient : coefficients) {
+    coefficient = utils::RandomElement<Elem>(random_gen);
+  }
+  const Poly a(std::move(coefficients));
+
+  if constexpr (Elem::FieldBase() == 2) {
+    const Poly sum = FrobeniusFold(
+        a, xq, degree, mod,
+        [](const Poly& lhs, const Poly& rhs) { return lhs.Add(rhs); }, lookup);
+    Poly term = sum;
+    Poly result = sum;
+    for (size_t i = 1; i < Elem::FieldPower(); ++i) {
+      term = std::move(term).Sqr().Rem(mod);
+      result = std::move(result).Add(term);
+    }
+    return result;
+  } else {
+    constexpr uint64_t kHalf = (utils::FieldSize<Elem>() - 1) / 2;
+    const Poly power = polynomial::BinPowMod(a, kHalf, mod);
+    return FrobeniusFold(
+               power, xq, degree, mod,
+               [&mod](const Poly& lhs, const Poly& rhs) {
+                 return lhs.Mul(rhs).Rem(mod);
+               },
+               lookup)
+        .Sub(Elem::One());
+  }
+}
+
+/*! @brief Appends the irreducible factors of f to factors.
+ *
+ *  Frobenius powers stored in table, if any, are reduced modulo f instead of
+ *  being composed.
+ *
+ *  @pre f is monic and is a product of distinct irreducible factors of the
+ *       given degree.
+ *  @pre mod is the modulus of f and xq = x^q (mod f).
+ *  @pre table is null or was computed modulo a multiple of f.
+ */
+template <concepts::Polynom Poly, typename RandomGen>
+void Split(const Poly& f, const typename Poly::Modulus& mod, const Poly& xq,
+           int degree, const ddf::FrobeniusTable<Poly>* table,
+           RandomGen& random_gen, std::vector<Poly>& factors) {
+  if (f.Size() <= static_cast<size_t>(degree) + 1) {
+    if (f.Size() > 1) {
+      factors.push_back(f);
+    }
+    return;
+  }
+
+  // Every attempt looks up the same powers, they are reduced once.
+  std::map<int, Poly> reduced;
+  auto lookup = [&](int k) -> std::optional<Poly> {
+    const Poly* power = table != nullptr ? table->Find(k) : nullptr;
+    if (power == nullptr) {
+      return std::nullopt;
+    }
+    auto it = reduced.find(k);
+    if (it == reduced.end()) {
+      it = reduced.emplace(k, power->Rem(f)).first;
+    }
+    return it->second;
+  };
+
+  while (true) {
+    Poly divisor = f.Gcd(SplittingPolynomial(xq, degree, mod, f.Size(),
+                                             random_gen, lookup))
+                       .MakeMonic();
+    if (divisor.Size() <= 1 || divisor.Size() >= f.Size()) {
+      continue;
+    }
+    Poly other = f.Div(divisor).MakeMonic();
+
+    // Moduli of both parts are derived from the modulus of f.
+    const auto divisor_mod = polynomial::RebuildModulus(divisor, mod, other,
+                                                        2 * divisor.Size());
+    Split(divisor, divisor_mod, xq.Rem(divisor), degree, table, random_gen,
+          factors);
+    const auto other_mod = polynomial::RebuildModulus(other, mod, divisor,
+                                                      2 * other.Size());
+    Split(other, other_mod, xq.Rem(other), degree, table, random_gen,
+          factors);
+    return;
+  }
+}
+
+}  // namespace detail
+
+/*! @brief Returns the irreducible factors of poly, a product of distinct
+ *  irreducible factors of the same degree.
+ *
+ *  Factors are monic, their order is unspecified. Zero and constant
+ *  polynomials have no factors in the result.
+ *
+ *  @pre poly is square-free and all its irreducible factors have the given
+ *       degree, e.g. poly is an entry of DDF.
+ */
+template <concepts::Polynom Poly, typename RandomGen>
+std::vector<Poly> EqualDegreeFactorize(Poly poly, int degree,
+                                       RandomGen& random_gen) {
+  using Element = typename Poly::Element;
+
+  poly = std::move(poly).MakeMonic();
+  if (poly.IsZero() || poly.IsOne()) {
+    return {};
+  }
+
+  const auto mod = poly.BuildModulus(2 * poly.Size());
+  const Poly x = Poly(std::vector<Element>{Element::Zero(), Element::One()})
+                     .Rem(mod);
+  std::vector<Poly> factors;
+  detail::Split<Poly>(poly, mod, polynomial::FrobeniusMod(x, mod), degree,
+                      nullptr, random_gen, factors);
+  return factors;
+}
+
+/*! @brief EqualDegreeFactorize for an entry of a baby-step/giant-step DDF,
+ *  which reuses the Frobenius powers of the DDF run.
+ *
+ *  x^q and the powers x^(q^k) of the doubling chain that the table stores are
+ *  reduced instead of being recomputed, so every split composes only the
+ *  folded polynomial at those steps.
+ *
+ *  @code
+ *    ddf::ntl_like::DistinctDegreeFactorizer<Poly> factorizer(poly);
+ *    const auto components = factorizer.Run();
+ *    const auto table = factorizer.Frobenius();
+ *    for (const auto& [factor, degree] : components) {
+ *      auto irreducibles = edf::EqualDegreeFactorize(factor, degree, table,
+ *                                                    random_gen);
+ *    }
+ *  @endcode
+ *
+ *  @pre table was computed by DDF of a multiple of poly.
+ */
+template <concepts::Polynom Poly, typename RandomGen>
+std::vector<Poly> EqualDegreeFactorize(Poly poly, int degree,
+                                       const ddf::FrobeniusTable<Poly>& table,
+                                       RandomGen& random_gen) {
+  poly = std::move(poly).MakeMonic();
+  if (poly.IsZero() || poly.IsOne()) {
+    return {};
+  }
+
+  const auto mod = poly.BuildModulus(2 * poly.Size());
+  const Poly* xq = table.Find(1);
+  assert(xq != nullptr);
+  std::vector<Poly> factors;
+  detail::Split(poly, mod, xq->Rem(poly), degree, &table, random_gen,
+                factors);
+  return factors;
+}
+
+/*! @brief EqualDegreeFactorize with a default seeded random generator. */
+template <concepts::Polynom Poly>
+std::vector<Poly> EqualDegreeFactorize(Poly poly, int degree) {
+  std::mt19937_64 random_gen;
+  return EqualDegreeFactorize(std::move(poly), degree, random_gen);
+}
+
+}  // namespace factorization::edf
@@ -0,0 +1,287 @@
+// MIT License
+//
+// Copyright (c) 2026 Andrei Ishutin
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <optional>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <factorization/concepts.hpp>
+#include <factorization/polynomial/common.hpp>
+#include <factorization/solver/berlekamp.hpp>
+#include <factorization/solver/common.hpp>
+#include <factorization/solver/distinct_degree_factorization.hpp>
+#include <factorization/solver/equal_degree_factorization.hpp>
+#include <factorization/solver/square_free_factorization.hpp>
+
+/*! @file
+ *  @brief Complete factorization over GF(q) with a choice of algorithm.
+ *
+ *  Factorizer runs square-free factorization and splits every square-free
+ *  part either by Berlekamp or by DDF followed by equal-degree factorization
+ *  with the Frobenius tables of the DDF run. The choice, together with the
+ *  DDF StepsMode, is made for every part by a cost model of n, q and the
+ *  polynomial engine, see ChoosePlan. A fixed FactorizationPlan overrides it.
+ *
+ *  @code
+ *    auto factors = factorization::solver::Factorizer<Poly>().Factorize(poly);
+ *  @endcode
+ */
+
+namespace factorization::solver {
+
+enum class FactorizationMethod {
+  // Berlekamp subalgebra, see Berlekamp.
+  kBerlekamp,
+  // ntl_like DDF, then equal-degree factorization of its components.
+  kDistinctDegree,
+};
+
+/*! @brief Algorithm for the square-free parts of a polynomial. */
+struct FactorizationPlan {
+  FactorizationMethod method = FactorizationMethod::kDistinctDegree;
+  // Used by kDistinctDegree only.
+  ddf::StepsMode steps_mode = ddf::kSmallField;
+
+  bool operator==(const FactorizationPlan&) const = default;
+};
+
+namespace detail {
+
+// Costs below are estimated numbers of field multiplications.
+
+// Engines without ProductCost are costed as Karatsuba with this schoolbook
+// threshold.
+inline constexpr double kSchoolbookSize = 128;
+
+// Berlekamp works on plain matrices and on short-lived polynomials. Its
+// elimination is a tight loop, cheaper per multiplication than polynomial
+// arithmetic, while every splitting gcd allocates. Both weights were fitted
+// by benchmarks/factorizer.cpp.
+inline constexpr double kEliminationWeight = 0.12;
+inline constexpr double kSplittingWeight = 12;
+// Prime fields too large for Berlekamp to enumerate reduce every product in
+// the elimination by a division, which makes it as costly per multiplication
+// as polynomial arithmetic.
+inline constexpr double kPrimeEliminationWeight = 1;
+
+template <concepts::Polynom Poly>
+double ProductCost(double n) {
+  if constexpr (requires { typename Poly::EngineType; }) {
+    using Engine = typename Poly::EngineType;
+    if constexpr (requires { Engine::ProductCost(size_t{}); }) {
+      return Engine::ProductCost(static_cast<size_t>(n));
+    } else if (n > kSchoolbookSize) {
+      return kSchoolbookSize * kSchoolbookSize *
+             std::pow(n / kSchoolbookSize, std::log2(3.0));
+    }
+  }
+  return n * n;
+}
+
+// A product followed by a reduction, which takes two more products.
+template <concepts::Polynom Poly>
+double MulModCost(double n) {
+  return 3 * ProductCost<Poly>(n);
+}
+
+// Mirrors polynomial::FrobeniusMod: p - 1 block reductions per characteristic
+// power for small p, binary exponentiation by q otherwise.
+template <concepts::Polynom Poly>
+double FrobeniusCost(double n) {
+  using Element = typename Poly::Element;
+  constexpr double kBase = Element::FieldBase();
+  constexpr double kPower = Element::FieldPower();
+  if constexpr (Element::FieldBase() <= polynomial::kFrobeniusSpreadMaxBase) {
+    return kPower * (kBase - 1) * 2 * ProductCost<Poly>(n);
+  } else {
+    return 1.5 * kPower * std::log2(kBase) * MulModCost<Poly>(n);
+  }
+}
+
+// Brent-Kung composition with blocks of size sqrt(n): the power table and
+// Horner's rule take about 2 sqrt(n) modular products, the block products
+// about n^2 multiplications.
+template <concepts::Polynom Poly>
+double CompositionCost(double n) {
+  return 2 * std::sqrt(n) * MulModCost<Poly>(n) + n * n;
+}
+
+template <concepts::Polynom Poly, ddf::StepsMode kMode>
+double DistinctDegreeCost(int n) {
+  const double l =
+      ddf::ntl_like::DistinctDegreeFactorizer<Poly, kMode>::BabyStepCount(n);
+  const double m = std::ceil(n / (2 * l));
+  const double baby_steps = kMode == ddf::kSmallField
+                                ? l * FrobeniusCost<Poly>(n)
+                                : FrobeniusCost<Poly>(n) +
+                                      (l - 1) * CompositionCost<Poly>(n);
+  const double giant_steps = m * CompositionCost<Poly>(n);
+  // Interval products take l modular products for each of m intervals.
+  const double refine = m * l * MulModCost<Poly>(n);
+  return baby_steps + giant_steps + refine;
+}
+
+template <concepts::Polynom Poly>
+double BerlekampCost(int n) {
+  using Element = typename Poly::Element;
+  const double q = std::pow(static_cast<double>(Element::FieldBase()),
+                            static_cast<double>(Element::FieldPower()));
+  const double size = n;
+  const bool enumerate = q <= Berlekamp<Poly>::kEnumerationMaxField;
+  // Rows x^(qi) (mod f). For q < n each is a schoolbook product by x^q
+  // (mod f) of q + 1 coefficients and a division with a quotient of the same
+  // size, otherwise a full modular product, measured at about 1.5 of
+  // MulModCost.
+  const double rows = q + 1 < size ? 2 * size * size * (q + 1)
+                                   : 1.5 * size * MulModCost<Poly>(size);
+  const double elimination =
+      (!enumerate && Element::FieldPower() == 1 ? kPrimeEliminationWeight
+                                                : kEliminationWeight) *
+      size * size * size;
+  if (enumerate) {
+    // Gcds with b - c for every field element c.
+    return rows + elimination + kSplittingWeight * q * size * size;
+  }
+  // x^q (mod f) for the matrix and random splitting. Every round raises b to
+  // the power (q - 1) / 2 modulo each part and takes a gcd; the parts shrink
+  // quickly, so all rounds cost about twice the first one.
+  return rows + elimination + FrobeniusCost<Poly>(size) +
+         2 * (1.5 * std::log2(q) * MulModCost<Poly>(size) +
+              kSplittingWeight * size * size);
+}
+
+}  // namespace detail
+
+/*! @brief Complete factorization: SFF, then Berlekamp or DDF and EDF.
+ *
+ *  Default-constructed factorizers choose the plan of every square-free part
+ *  by ChoosePlan.
+ */
+template <concepts::Polynom Polynom>
+class Factorizer {
+ public:
+  Factorizer() = default;
+
+  /*! @brief Uses plan for every square-free part. */
+  explicit Factorizer(FactorizationPlan plan)
+      : plan_(plan) {
+  }
+
+  /*! @brief Returns the cheapest plan for a square-free polynomial of degree
+   *  n by the cost model.
+   */
+  static FactorizationPlan ChoosePlan(int n) {
+    const double small_field =
+        detail::DistinctDegreeCost<Polynom, ddf::kSmallField>(n);
+    const double exact_ntl =
+        detail::DistinctDegreeCost<Polynom, ddf::kExactNtl>(n);
+    const double berlekamp = detail::BerlekampCost<Polynom>(n);
+
+    if (berlekamp <= std::min(small_field, exact_ntl)) {
+      return {FactorizationMethod::kBerlekamp};
+    }
+    return {FactorizationMethod::kDistinctDegree,
+            small_field <= exact_ntl ? ddf::kSmallField : ddf::kExactNtl};
+  }
+
+  /*! @brief Factorizes a polynomial into irreducible factors with powers.
+   *
+   *  random_gen drives equal-degree splitting and Berlekamp splitting over
+   *  large fields.
+   */
+  template <typename RandomGen>
+  std::vector<Factor<Polynom>> Factorize(Polynom polynom,
+                                         RandomGen& random_gen) const {
+    std::vector<Factor<Polynom>> result;
+    polynom = std::move(polynom).MakeMonic();
+    if (polynom.IsZero() || polynom.IsOne()) {
+      return {};
+    }
+    for (const auto& [sf_factor, power] : sff::SquareFreeFactorize(polynom)) {
+      Polynom part = sf_factor.MakeMonic();
+      if (part.IsOne()) {
+        continue;
+      }
+      const int n = static_cast<int>(part.Size()) - 1;
+      const FactorizationPlan plan = plan_.value_or(ChoosePlan(n));
+      for (auto& factor :
+           FactorizeSquareFree(std::move(part), plan, random_gen)) {
+        result.emplace_back(std::move(factor), power);
+      }
+    }
+    return result;
+  }
+
+  /*! @brief Factorize with a default seeded random generator. */
+  std::vector<Factor<Polynom>> Factorize(Polynom polynom) const {
+    std::mt19937_64 random_gen;
+    return Factorize(std::move(polynom), random_gen);
+  }
+
+ private:
+  template <typename RandomGen>
+  static std::vector<Polynom> FactorizeSquareFree(Polynom polynom,
+                                                  FactorizationPlan plan,
+                                                  RandomGen& random_gen) {
+    if (polynom.Size() <= 2) {
+      return {std::move(polynom)};
+    }
+    if (plan.method == FactorizationMethod::kBerlekamp) {
+      return Berlekamp<Polynom>().FactorizeSquareFree(std::move(polynom),
+                                                      random_gen);
+    }
+    if (plan.steps_mode == ddf::kExactNtl) {
+      return SplitDistinctDegree<ddf::kExactNtl>(std::move(polynom),
+                                                 random_gen);
+    }
+    return SplitDistinctDegree<ddf::kSmallField>(std::move(polynom),
+                                                 random_gen);
+  }
+
+  template <ddf::StepsMode kMode, typename RandomGen>
+  static std::vector<Polynom> SplitDistinctDegree(Polynom polynom,
+                                                  RandomGen& random_gen) {
+    ddf::ntl_like::DistinctDegreeFactorizer<Polynom, kMode> factorizer(
+        std::move(polynom));
+    const auto components = factorizer.Run();
+    const auto table = factorizer.Frobenius();
+
+    std::vector<Polynom> result;
+    for (const auto& [factor, degree] : components) {
+      for (auto& irreducible :
+           edf::EqualDegreeFactorize(factor, degree, table, random_gen)) {
+        result.push_back(std::move(irreducible));
+      }
+    }
+    return result;
+  }
+
+  std::optional<FactorizationPlan> plan_;
+};
+
+}  // namespace factorization::solver
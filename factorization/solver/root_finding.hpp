@@ -0,0 +1,211 @@
+// MIT License
+//
+// Copyright (c) 2026 Andrei Ishutin
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <factorization/concepts.hpp>
+#include <factorization/polynomial/common.hpp>
+#include <factorization/polynomial/subproduct_tree.hpp>
+#include <factorization/utils.hpp>
+
+/*! @file
+ *  @brief Roots of polynomials over a finite field GF(q).
+ *
+ *  Only the linear factors are extracted, which is much cheaper than a full
+ *  factorization: the product of the distinct linear factors is
+ *    g = gcd(f, x^q - x),
+ *  and g splits into linear factors by random gcds:
+ *    - for odd q, every root r of g satisfies (r + a)^((q - 1) / 2) = 1 for
+ *      about half of a, so gcd(g, (x + a)^((q - 1) / 2) - 1) is a proper
+ *      divisor of g with probability about 1/2;
+ *    - for q = 2^m, the trace Tr(b x) = b x + (b x)^2 + ... + (b x)^(2^(m-1))
+ *      takes values 0 and 1 only, so gcd(g, Tr(b x) (mod g)) does the same.
+ *
+ *  For small fields g can be evaluated at every element instead, see
+ *  RootsMethod.
+ *
+ *  @code
+ *    auto roots = factorization::roots::FindRoots(poly);
+ *  @endcode
+ */
+
+namespace factorization::roots {
+
+enum class RootsMethod {
+  // Evaluation when q is small compared to deg g, splitting otherwise.
+  kAuto,
+  // Random splitting of g.
+  kSplit,
+  // Evaluation of g at all q elements, by a subproduct tree if the
+  // polynomial has an engine, otherwise by Horner's rule.
+  kEvaluate,
+};
+
+namespace detail {
+
+// kAuto evaluates g if q is at most this many times deg g.
+inline constexpr uint64_t kEvaluationFactor = 4;
+
+template <concepts::Polynom Poly>
+using Element = typename Poly::Element;
+
+// Returns Tr(b x) (mod g) for q = 2^m.
+template <concepts::Polynom Poly>
+Poly TraceMod(const Element<Poly>& b, const typename Poly::Modulus& mod) {
+  constexpr auto kDegree = Element<Poly>::FieldPower();
+  Poly term(std::vector<Element<Poly>>{Element<Poly>::Zero(), b});
+  term = std::move(term).Rem(mod);
+  Poly result = term;
+  for (size_t i = 1; i < kDegree; ++i) {
+    term = std::move(term).Sqr().Rem(mod);
+    result = std::move(result).Add(term);
+  }
+  return result;
+}
+
+/*! @brief Appends the roots of g to roots.
+ *
+ *  @pre g is monic and is a product of distinct linear factors.
+ */
+template <concepts::Polynom Poly, typename RandomGen>
+void SplitRoots(Poly g, RandomGen& random_gen,
+                std::vector<Element<Poly>>& roots) {
+  using Elem = Element<Poly>;
+  if (g.Size() <= 1) {
+    return;
+  }
+  if (g.Size() == 2) {
+    roots.push_back(-g.View()[0]);
+    return;
+  }
+
+  const auto mod = g.BuildModulus(2 * g.Size());
+  while (true) {
+    const Elem a = utils::RandomElement<Elem>(random_gen);
+    Poly split;
+    if constexpr (Elem::FieldBase() == 2) {
+      split = TraceMod<Poly>(a, mod);
+    } else {
+      constexpr uint64_t kHalf = (utils::FieldSize<Elem>() - 1) / 2;
+      Poly shifted(std::vector<Elem>{a, Elem::One()});
+      split = polynomial::BinPowMod(std::move(shifted).Rem(mod), kHalf, mod)
+                  .Sub(Elem::One());
+    }
+    Poly divisor = g.Gcd(split);
+    if (divisor.Size() > 1 && divisor.Size() < g.Size()) {
+      Poly other = g.Div(divisor).MakeMonic();
+      SplitRoots(std::move(divisor).MakeMonic(), random_gen, roots);
+      SplitRoots(std::move(other), random_gen, roots);
+      return;
+    }
+  }
+}
+
+template <concepts::Polynom Poly>
+std::vector<Element<Poly>> EvaluateRoots(const Poly& g) {
+  using Elem = Element<Poly>;
+  std::vector<Elem> elements;
+  elements.reserve(utils::FieldSize<Elem>());
+  for (const auto& element : Elem::AllFieldElements()) {
+    elements.push_back(element);
+  }
+  std::vector<Elem> roots;
+
+  if constexpr (requires { typename Poly::EngineType; }) {
+    const polynomial::SubproductTree<Elem, typename Poly::EngineType> tree(
+        elements);
+    const auto values = tree.Evaluate(g.Get());
+    for (size_t i = 0; i < elements.size(); ++i) {
+      if (values[i] == Elem::Zero()) {
+        roots.push_back(elements[i]);
+      }
+    }
+  } else {
+    const auto coefficients = g.View();
+    for (const auto& element : elements) {
+      Elem value = Elem::Zero();
+      for (size_t i = coefficients.size(); i-- > 0;) {
+        value = value * element + coefficients[i];
+      }
+      if (value == Elem::Zero()) {
+        roots.push_back(element);
+      }
+    }
+  }
+  return roots;
+}
+
+}  // namespace detail
+
+/*! @brief Returns the distinct roots of poly in GF(q) in increasing order.
+ *
+ *  Zero and constant polynomials have no roots in the result.
+ */
+template <concepts::Polynom Poly, typename RandomGen>
+std::vector<typename Poly::Element> FindRoots(
+    Poly poly, RandomGen& random_gen, RootsMethod method = RootsMethod::kAuto) {
+  using Element = typename Poly::Element;
+
+  poly = std::move(poly).MakeMonic();
+  if (poly.IsZero() || poly.IsOne()) {
+    return {};
+  }
+
+  // g = gcd(f, x^q - x), the product of distinct linear factors of f.
+  const auto mod = poly.BuildModulus(2 * poly.Size());
+  const Poly x = Poly(std::vector<Element>{Element::Zero(), Element::One()})
+                     .Rem(mod);
+  Poly g = poly.Gcd(polynomial::FrobeniusMod(x, mod).Sub(x)).MakeMonic();
+
+  if (method == RootsMethod::kAuto) {
+    method = utils::FieldSize<Element>() <=
+                     detail::kEvaluationFactor * (g.Size() - 1)
+                 ? RootsMethod::kEvaluate
+                 : RootsMethod::kSplit;
+  }
+
+  std::vector<Element> roots;
+  if (method == RootsMethod::kEvaluate) {
+    roots = detail::EvaluateRoots(g);
+  } else {
+    detail::SplitRoots(std::move(g), random_gen, roots);
+  }
+  std::sort(roots.begin(), roots.end());
+  return roots;
+}
+
+/*! @brief FindRoots with a default seeded random generator. */
+template <concepts::Polynom Poly>
+std::vector<typename Poly::Element> FindRoots(
+    Poly poly, RootsMethod method = RootsMethod::kAuto) {
+  std::mt19937_64 random_gen;
+  return FindRoots(std::move(poly), random_gen, method);
+}
+
+}  // namespace factorization::roots
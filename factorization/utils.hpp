@@ -22,6 +22,9 @@
 
 #pragma once
 
+#include <array>
+#include <cstdint>
+
 namespace factorization::utils {
 
 template <class Iterator>
@@ -57,4 +60,24 @@ constexpr inline Value BinPow(Value base, Power power) {
   return result;
 }
 
+/*! @brief Returns a uniformly random element of a Galois field, up to the
+ *  bias of taking the generator output modulo the field base.
+ */
+template <typename Element, typename RandomGen>
+Element RandomElement(RandomGen& random_gen) {
+  std::array<typename Element::Coefficient, Element::FieldPower()> result;
+  for (auto& coefficient : result) {
+    coefficient = static_cast<typename Element::Coefficient>(
+        random_gen() % Element::FieldBase());
+  }
+  return Element(result);
+}
+
+/*! @brief Returns the number of elements of the Galois field of Element. */
+template <typename Element>
+constexpr inline uint64_t FieldSize() {
+  return BinPow(static_cast<uint64_t>(Element::FieldBase()),
+                Element::FieldPower());
+}
+
 }  // namespace factorization::utils
@@ -1,9 +1,11 @@
+#include <algorithm>
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <cmath>
 #include <iostream>
 #include <random>
+#include <stdexcept>
 #include <utility>
 #include <vector>
 
@@ -15,9 +17,14 @@
 #include <factorization/galois_field/prime_ring.hpp>
 #include <factorization/polynomial/common.hpp>
 #include <factorization/polynomial/generic_polynomial.hpp>
+#include <factorization/polynomial/hybrid_engine.hpp>
 #include <factorization/polynomial/karatsuba_engine.hpp>
 #include <factorization/polynomial/naive_polynomial.hpp>
 #include <factorization/polynomial/ntt_engine.hpp>
+#include <factorization/polynomial/shared_polynomial.hpp>
+#include <factorization/polynomial/subproduct_tree.hpp>
+#include <factorization/runtime/parallel_for.hpp>
+#include <factorization/runtime/thread_pool.hpp>
 
 #include "generator.hpp"
 
@@ -34,16 +41,24 @@ Poly MakePoly(std::vector<int> data) {
   return Poly(std::move(result));
 }
 
+template <typename Poly>
+concept ViewsTemporary = requires(Poly poly) { std::move(poly).View(); };
+
 template <concepts::Polynom Reference, concepts::Polynom Verify,
           size_t kMaxSize, typename RandomGen>
 void RunCompareTest(RandomGen& random_gen) {
+  static_assert(!ViewsTemporary<Reference> && !ViewsTemporary<Verify>);
+
   auto first = GenPoly<Reference, kMaxSize>(random_gen);
   auto second = GenPoly<Reference, kMaxSize>(random_gen);
 
   Verify generic_first(first.Get());
   Verify generic_second(second.Get());
+  REQUIRE(std::ranges::equal(generic_first.View(), first.View()));
 
   REQUIRE(generic_first.Mul(generic_second).Get() == first.Mul(second).Get());
+  REQUIRE(first.Sqr().Get() == first.Mul(first).Get());
+  REQUIRE(generic_first.Sqr().Get() == first.Sqr().Get());
   REQUIRE(generic_first.Div(generic_second).Get() == first.Div(second).Get());
   REQUIRE(generic_first.Rem(generic_second).Get() == first.Rem(second).Get());
 
@@ -357,6 +372,39 @@ TEST_CASE("GenericPolynomial") {
     }
   }
 
+  SECTION("NTT sizes near powers of two") {
+    using GaloisField = galois_field::PrimeRing<17>;
+    using Element = galois_field::FieldElementWrapper<GaloisField>;
+    using NaivePoly = polynomial::NaivePolynomial<Element>;
+    using Engine = polynomial::NttEngine<Element>;
+    using GenericPoly = polynomial::GenericPolynomial<Element, Engine>;
+
+    // Products of size 2^k + small are split into a cyclic product and a
+    // correction of the low coefficients.
+    for (size_t first_size : {33, 65, 100, 257, 300, 513}) {
+      for (size_t second_size : {1, 2, 31, 33, 64, 65, 200, 257}) {
+        std::vector<Element> first(first_size);
+        std::vector<Element> second(second_size);
+        for (auto& value : first) {
+          value = GenElement<Element>(random_gen);
+        }
+        for (auto& value : second) {
+          value = GenElement<Element>(random_gen);
+        }
+        first.back() = Element::One();
+        second.back() = Element::One();
+
+        const NaivePoly naive_first(first);
+        const NaivePoly naive_second(second);
+        const GenericPoly generic_first(first);
+        const GenericPoly generic_second(second);
+        REQUIRE(generic_first.Mul(generic_second).Get() ==
+                naive_first.Mul(naive_second).Get());
+        REQUIRE(generic_first.Sqr().Get() == naive_first.Sqr().Get());
+      }
+    }
+  }
+
   SECTION("Big NTT") {
     // NOLINTNEXTLINE
     using GaloisField = galois_field::PrimeRing<2524775926340780033, uint64_t, __int128_t>;
@@ -372,6 +420,27 @@ TEST_CASE("GenericPolynomial") {
     }
   }
 
+  SECTION("Karatsuba Half-GCD") {
+    using GaloisField = galois_field::LogBasedField<2, 3, {1, 1, 0, 1}>;
+    using Element = galois_field::FieldElementWrapper<GaloisField>;
+    using NaivePoly = polynomial::NaivePolynomial<Element>;
+    using Engine = polynomial::KaratsubaEngine<Element>;
+    using GenericPoly = polynomial::GenericPolynomial<Element, Engine>;
+
+    constexpr int kTestsCount = 5;
+
+    for (int test = 0; test < kTestsCount; ++test) {
+      auto common = GenPoly<NaivePoly, 500>(random_gen);
+      auto first = GenPoly<NaivePoly, 3000, kFixed>(random_gen).Mul(common);
+      auto second = GenPoly<NaivePoly, 2500>(random_gen).Mul(common);
+
+      const GenericPoly generic_first(first.Get());
+      const GenericPoly generic_second(second.Get());
+      REQUIRE(generic_first.Gcd(generic_second).MakeMonic().Get() ==
+              first.Gcd(second).Get());
+    }
+  }
+
   SECTION("Karatsuba mul speed") {
     using GaloisField = galois_field::LogBasedField<2, 3, {1, 1, 0, 1}>;
     using Element = galois_field::FieldElementWrapper<GaloisField>;
@@ -464,6 +533,12 @@ void RunCompModFrobeniusTest(RandomGen& random_gen) {
     const Poly actual = polynomial::CompMod(poly, matrix, modulus);
 
     REQUIRE(actual == expected);
+
+    // x composes to x^q (mod f), the first row of the table after 1.
+    const auto many =
+        polynomial::CompModMany(std::vector<Poly>{x, Poly(), poly}, matrix,
+                                modulus);
+    REQUIRE(many == std::vector<Poly>{Poly(matrix[1]), Poly(), expected});
   }
 }
 
@@ -504,4 +579,788 @@ TEST_CASE("CompMod") {
     RunCompModFrobeniusTest<Poly, 256, 128>(random_gen);
     RunCompModFrobeniusTest<Poly, 1024, 1024>(random_gen);
   }
+
+  SECTION("Z_17 NTT") {
+    using GaloisField = galois_field::PrimeRing<17>;
+    using Element = galois_field::FieldElementWrapper<GaloisField>;
+    using Engine = polynomial::NttEngine<Element>;
+    using Poly = polynomial::GenericPolynomial<Element, Engine>;
+
+    RunCompModFrobeniusTest<Poly, 256, 128>(random_gen);
+    RunCompModFrobeniusTest<Poly, 1024, 1024>(random_gen);
+  }
+
+  // Sums of products are accumulated in 64 bits, for this prime they have
+  // to be reduced after every term.
+  SECTION("Z_4294967291") {
+    using GaloisField =
+        galois_field::PrimeRing<4294967291, uint64_t, __int128_t>;
+    using Element = galois_field::FieldElementWrapper<GaloisField>;
+    using Engine = polynomial::KaratsubaEngine<Element>;
+    using Poly = polynomial::GenericPolynomial<Element, Engine>;
+
+    RunCompModFrobeniusTest<Poly, 256, 128>(random_gen);
+  }
+}
+
+template <concepts::Polynom Poly, size_t kMaxModSize, typename RandomGen>
+void RunFrobeniusTest(RandomGen& random_gen) {
+  using Element = typename Poly::Element;
+  constexpr size_t kFieldSize =
+      utils::BinPow(Element::FieldBase(), Element::FieldPower());
+  constexpr size_t kTestsCount = 100;
+
+  for (size_t test = 0; test < kTestsCount; ++test) {
+    Poly mod = GenPoly<Poly, kMaxModSize>(random_gen).MakeMonic();
+    const auto modulus = mod.BuildModulus(2 * mod.Size());
+
+    const Poly poly = GenPoly<Poly, kMaxModSize>(random_gen).Rem(modulus);
+    const Poly expected = polynomial::BinPowMod(poly, kFieldSize, modulus);
+    const Poly actual = polynomial::FrobeniusMod(poly, modulus);
+
+    REQUIRE(actual == expected);
+  }
+}
+
+TEST_CASE("FrobeniusMod") {
+  std::mt19937 random_gen;
+
+  SECTION("GF_2^3") {
+    using GaloisField = galois_field::LogBasedField<2, 3, {1, 1, 0, 1}>;
+    using Element = galois_field::FieldElementWrapper<GaloisField>;
+    using Engine = polynomial::KaratsubaEngine<Element>;
+    using Poly = polynomial::GenericPolynomial<Element, Engine>;
+
+    RunFrobeniusTest<Poly, 16>(random_gen);
+    RunFrobeniusTest<Poly, 1024>(random_gen);
+    RunFrobeniusTest<polynomial::NaivePolynomial<Element>, 256>(random_gen);
+  }
+
+  SECTION("Z_3") {
+    using GaloisField = galois_field::PrimeRing<3>;
+    using Element = galois_field::FieldElementWrapper<GaloisField>;
+    using Engine = polynomial::NttEngine<Element>;
+    using Poly = polynomial::GenericPolynomial<Element, Engine>;
+
+    RunFrobeniusTest<Poly, 16>(random_gen);
+    RunFrobeniusTest<Poly, 1024>(random_gen);
+    RunFrobeniusTest<polynomial::NaivePolynomial<Element>, 256>(random_gen);
+  }
+
+  SECTION("Z_17") {
+    using GaloisField = galois_field::PrimeRing<17>;
+    using Element = galois_field::FieldElementWrapper<GaloisField>;
+    using Engine = polynomial::NttEngine<Element>;
+    using Poly = polynomial::GenericPolynomial<Element, Engine>;
+
+    RunFrobeniusTest<Poly, 256>(random_gen);
+  }
+}
+
+template <concepts::Polynom Poly, size_t kDegree, typename RandomGen>
+void RunSparseModulusTest(RandomGen& random_gen) {
+  using Element = typename Poly::Element;
+  constexpr size_t kTestsCount = 100;
+
+  for (size_t test = 0; test < kTestsCount; ++test) {
+    // Random leading coefficient and up to four terms below it.
+    std::vector<Element> coefficients(kDegree + 1, Element::Zero());
+    while (coefficients.back() == Element::Zero()) {
+      coefficients.back() = GenElement<Element>(random_gen);
+    }
+    for (size_t i = 0; i <= test % 4; ++i) {
+      coefficients[random_gen() % kDegree] = GenElement<Element>(random_gen);
+    }
+    const Poly f(std::move(coefficients));
+    const auto modulus = f.BuildModulus();
+
+    // Dividends longer than 2 deg f are reduced as well.
+    const Poly a = GenPoly<Poly, 3 * kDegree>(random_gen);
+    REQUIRE(a.Rem(modulus) == a.Rem(f));
+    REQUIRE(a.Div(modulus) == a.Div(f));
+    REQUIRE(a.DivRem(modulus) == a.DivRem(f));
+  }
+}
+
+TEST_CASE("SparseModulus") {
+  std::mt19937 random_gen;
+
+  SECTION("GF_2^8") {
+    using GaloisField =
+        galois_field::LogBasedField<2, 8, {1, 0, 1, 1, 1, 0, 0, 0, 1}>;
+    using Element = galois_field::FieldElementWrapper<GaloisField>;
+    using Engine = polynomial::KaratsubaEngine<Element>;
+    using Poly = polynomial::GenericPolynomial<Element, Engine>;
+
+    RunSparseModulusTest<Poly, 16>(random_gen);
+    RunSparseModulusTest<Poly, 1024>(random_gen);
+  }
+
+  SECTION("Z_2") {
+    using GaloisField = galois_field::PrimeRing<2>;
+    using Element = galois_field::FieldElementWrapper<GaloisField>;
+    using Engine = polynomial::HybridEngine<Element>;
+    using Poly = polynomial::GenericPolynomial<Element, Engine>;
+
+    RunSparseModulusTest<Poly, 1024>(random_gen);
+  }
+
+  SECTION("Z_1000003 NTT") {
+    using GaloisField = galois_field::PrimeRing<1000003, uint64_t, __int128_t>;
+    using Element = galois_field::FieldElementWrapper<GaloisField>;
+    using Engine = polynomial::NttEngine<Element>;
+    using Poly = polynomial::GenericPolynomial<Element, Engine>;
+
+    RunSparseModulusTest<Poly, 16>(random_gen);
+    RunSparseModulusTest<Poly, 1024>(random_gen);
+  }
+}
+
+template <concepts::Polynom Poly, size_t kMaxSize, typename RandomGen>
+void RunRebuildModulusTest(RandomGen& random_gen) {
+  constexpr size_t kTestsCount = 20;
+
+  for (size_t test = 0; test < kTestsCount; ++test) {
+    const Poly g = GenPoly<Poly, kMaxSize, kFixed>(random_gen);
+    const Poly d = GenPoly<Poly, kMaxSize>(random_gen);
+    const Poly f = g.Mul(d);
+    const auto f_modulus = f.BuildModulus(2 * f.Size());
+
+    // Capacity shrinking with the modulus as in GiantRefine, and a fixed
+    // one as in IntervalRefine.
+    for (const size_t max_dividend_size : {2 * g.Size(), 2 * f.Size()}) {
+      const auto modulus =
+          polynomial::RebuildModulus(g, f_modulus, d, max_dividend_size);
+      const Poly a = GenPoly<Poly, kMaxSize>(random_gen).Mul(
+          GenPoly<Poly, kMaxSize>(random_gen));
+      REQUIRE(a.Rem(modulus) == a.Rem(g));
+      REQUIRE(a.DivRem(modulus) == a.DivRem(g));
+    }
+  }
+}
+
+TEST_CASE("RebuildModulus") {
+  std::mt19937 random_gen;
+
+  SECTION("GF_2^8") {
+    using GaloisField =
+        galois_field::LogBasedField<2, 8, {1, 0, 1, 1, 1, 0, 0, 0, 1}>;
+    using Element = galois_field::FieldElementWrapper<GaloisField>;
+    using Engine = polynomial::KaratsubaEngine<Element>;
+    using Poly = polynomial::GenericPolynomial<Element, Engine>;
+
+    RunRebuildModulusTest<Poly, 64>(random_gen);
+    RunRebuildModulusTest<Poly, 1024>(random_gen);
+  }
+
+  SECTION("Z_17 NTT") {
+    using GaloisField = galois_field::PrimeRing<17>;
+    using Element = galois_field::FieldElementWrapper<GaloisField>;
+    using Engine = polynomial::NttEngine<Element>;
+    using Poly = polynomial::GenericPolynomial<Element, Engine>;
+
+    RunRebuildModulusTest<Poly, 64>(random_gen);
+    RunRebuildModulusTest<Poly, 1024>(random_gen);
+  }
+
+  SECTION("Z_1000003 Hybrid") {
+    using GaloisField = galois_field::PrimeRing<1000003, uint64_t, __int128_t>;
+    using Element = galois_field::FieldElementWrapper<GaloisField>;
+    using Engine = polynomial::HybridEngine<Element>;
+    using Poly = polynomial::GenericPolynomial<Element, Engine>;
+
+    RunRebuildModulusTest<Poly, 1024>(random_gen);
+  }
+}
+
+TEST_CASE("SharedPolynomial") {
+  std::mt19937 random_gen;
+  using GaloisField = galois_field::PrimeRing<1000003, uint64_t, __int128_t>;
+  using Element = galois_field::FieldElementWrapper<GaloisField>;
+  using Engine = polynomial::HybridEngine<Element>;
+  using Poly = polynomial::GenericPolynomial<Element, Engine>;
+  using SharedPoly = polynomial::SharedPolynomial<Poly>;
+  constexpr size_t kTestsCount = 50;
+
+  REQUIRE(SharedPoly()->IsZero());
+  for (size_t test = 0; test < kTestsCount; ++test) {
+    const Poly a = GenPoly<Poly, 256>(random_gen);
+    Poly f;
+    do {
+      f = GenPoly<Poly, 128>(random_gen).MakeMonic();
+    } while (f.Size() < 2);
+    const auto modulus = f.BuildModulus(2 * a.Size());
+
+    auto table = polynomial::Share(std::vector<Poly>{a, a.Rem(modulus)});
+    auto copy = table;
+    REQUIRE(table[0].UseCount() == 2);
+    REQUIRE(&*copy[0] == &*table[0]);
+
+    // Reduced polynomials stay shared, others get a new version.
+    copy[1].Reduce(modulus, f.Size());
+    REQUIRE(&*copy[1] == &*table[1]);
+    copy[0].Reduce(modulus, f.Size());
+    REQUIRE(*table[0] == a);
+    REQUIRE(*copy[0] == *table[1]);
+    if (a.Size() >= f.Size()) {
+      REQUIRE(table[0].UseCount() == 1);
+    }
+
+    // The only owner is reduced in place.
+    const Poly* data = &*table[0];
+    table[0].Reduce(modulus, f.Size());
+    REQUIRE(&*table[0] == data);
+    REQUIRE(*table[0] == *table[1]);
+  }
+}
+
+template <concepts::Polynom Poly, size_t kMaxModSize, typename RandomGen>
+void RunPowerProjectionTest(RandomGen& random_gen) {
+  using Element = typename Poly::Element;
+  constexpr size_t kTestsCount = 50;
+
+  for (size_t test = 0; test < kTestsCount; ++test) {
+    Poly f;
+    do {
+      f = GenPoly<Poly, kMaxModSize>(random_gen).MakeMonic();
+    } while (f.Size() < 2);
+    const size_t n = f.Size() - 1;
+    const auto modulus = f.BuildModulus(2 * f.Size());
+    const Poly h = GenPoly<Poly, kMaxModSize>(random_gen).Rem(modulus);
+
+    std::vector<Element> form(n);
+    for (auto& value : form) {
+      value = GenElement<Element>(random_gen);
+    }
+    const size_t count = 2 * n + random_gen() % 8;
+    const size_t t = 1 + random_gen() % (n + 1);
+    const auto matrix = polynomial::BuildCompModMatrix(h, t, modulus);
+
+    std::vector<Element> expected;
+    Poly power(Element::One());
+    for (size_t i = 0; i < count; ++i) {
+      const auto coefficients = power.Get();
+      Element value = Element::Zero();
+      for (size_t j = 0; j < coefficients.size(); ++j) {
+        value += form[j] * coefficients[j];
+      }
+      expected.push_back(value);
+      power = std::move(power).Mul(h).Rem(modulus);
+    }
+    REQUIRE(polynomial::PowerProjection(form, count, matrix, f) == expected);
+
+    // The minimal polynomial annihilates h and is divisible by the one of
+    // every power projection sequence, x has f as its minimal polynomial.
+    const Poly min_poly = polynomial::MinPolyMod(h, f);
+    REQUIRE(min_poly.Get().back() == Element::One());
+    REQUIRE(polynomial::CompMod(min_poly, matrix, modulus).IsZero());
+    REQUIRE(
+        min_poly.Rem(polynomial::BerlekampMassey<Poly>(expected)).IsZero());
+
+    const Poly x =
+        Poly(std::vector<Element>{Element::Zero(), Element::One()}).Rem(
+            modulus);
+    REQUIRE(polynomial::MinPolyMod(x, f) == f);
+  }
+}
+
+TEST_CASE("PowerProjection") {
+  std::mt19937 random_gen;
+
+  SECTION("GF_2^3") {
+    using GaloisField = galois_field::LogBasedField<2, 3, {1, 1, 0, 1}>;
+    using Element = galois_field::FieldElementWrapper<GaloisField>;
+    using Engine = polynomial::KaratsubaEngine<Element>;
+    using Poly = polynomial::GenericPolynomial<Element, Engine>;
+
+    RunPowerProjectionTest<Poly, 16>(random_gen);
+    RunPowerProjectionTest<Poly, 128>(random_gen);
+  }
+
+  SECTION("Z_2") {
+    using GaloisField = galois_field::PrimeRing<2>;
+    using Element = galois_field::FieldElementWrapper<GaloisField>;
+    using Engine = polynomial::KaratsubaEngine<Element>;
+    using Poly = polynomial::GenericPolynomial<Element, Engine>;
+
+    RunPowerProjectionTest<Poly, 64>(random_gen);
+  }
+
+  SECTION("Z_1000003") {
+    using GaloisField = galois_field::PrimeRing<1000003, uint64_t, __int128_t>;
+    using Element = galois_field::FieldElementWrapper<GaloisField>;
+    using Engine = polynomial::HybridEngine<Element>;
+    using Poly = polynomial::GenericPolynomial<Element, Engine>;
+
+    RunPowerProjectionTest<Poly, 256>(random_gen);
+  }
+
+  SECTION("NaivePolynomial") {
+    using GaloisField = galois_field::PrimeRing<17>;
+    using Element = galois_field::FieldElementWrapper<GaloisField>;
+    using Poly = polynomial::NaivePolynomial<Element>;
+
+    RunPowerProjectionTest<Poly, 32>(random_gen);
+  }
+}
+
+// set_scheduler(scheduler, test) makes the engine of Poly use scheduler.
+template <concepts::Polynom Poly, size_t kMaxSize, typename RandomGen,
+          typename SetScheduler>
+void RunParallelMulTest(RandomGen& random_gen, SetScheduler set_scheduler) {
+  constexpr size_t kTestsCount = 20;
+
+  runtime::ThreadPool thread_pool(4);
+  thread_pool.Start();
+  for (size_t test = 0; test < kTestsCount; ++test) {
+    const Poly first = GenPoly<Poly, kMaxSize>(random_gen);
+    const Poly second = GenPoly<Poly, kMaxSize>(random_gen);
+    const auto modulus = second.BuildModulus(2 * kMaxSize);
+
+    const auto product = first.Mul(second);
+    const auto square = first.Sqr();
+    const auto [quotient, remainder] = first.Mul(first).DivRem(modulus);
+
+    set_scheduler(&thread_pool, test);
+    REQUIRE(first.Mul(second) == product);
+    REQUIRE(first.Sqr() == square);
+    REQUIRE(first.Mul(first).DivRem(modulus) ==
+            std::pair{quotient, remainder});
+    set_scheduler(nullptr, test);
+  }
+  thread_pool.Stop();
+}
+
+TEST_CASE("ParallelNtt") {
+  std::mt19937 random_gen;
+
+  SECTION("Z_1000003 NTT") {
+    using GaloisField = galois_field::PrimeRing<1000003, uint64_t, __int128_t>;
+    using Element = galois_field::FieldElementWrapper<GaloisField>;
+    using Engine = polynomial::NttEngine<Element>;
+    using Poly = polynomial::GenericPolynomial<Element, Engine>;
+
+    // Both dimensions of the four-step method are equal for even powers of
+    // two and differ by a factor of two for odd ones.
+    RunParallelMulTest<Poly, 4096>(
+        random_gen, [](runtime::IScheduler* scheduler, size_t test) {
+          Engine::SetScheduler(scheduler, 4 << (test % 2));
+        });
+  }
+
+  SECTION("Z_2 Hybrid") {
+    using GaloisField = galois_field::PrimeRing<2>;
+    using Element = galois_field::FieldElementWrapper<GaloisField>;
+    using Engine = polynomial::HybridEngine<Element>;
+    using Poly = polynomial::GenericPolynomial<Element, Engine>;
+
+    RunParallelMulTest<Poly, 4096>(
+        random_gen, [](runtime::IScheduler* scheduler, size_t test) {
+          Engine::SetScheduler(scheduler, 4 << (test % 2));
+        });
+  }
+}
+
+TEST_CASE("ParallelKaratsuba") {
+  std::mt19937 random_gen;
+
+  SECTION("GF_2^8") {
+    using GaloisField =
+        galois_field::LogBasedField<2, 8, {1, 0, 1, 1, 1, 0, 0, 0, 1}>;
+    using Element = galois_field::FieldElementWrapper<GaloisField>;
+    using Engine = polynomial::KaratsubaEngine<Element>;
+    using Poly = polynomial::GenericPolynomial<Element, Engine>;
+
+    // Products are split for one to three levels.
+    RunParallelMulTest<Poly, 4096>(
+        random_gen, [](runtime::IScheduler* scheduler, size_t test) {
+          Engine::SetScheduler(scheduler, 256, 1 + test % 3);
+        });
+  }
+}
+
+TEST_CASE("ParallelFor") {
+  runtime::ThreadPool thread_pool(4);
+  thread_pool.Start();
+
+  // The chunk of 5 stops there, the other chunks finish, and the exception
+  // reaches the caller instead of leaving it waiting for the failed chunk.
+  std::vector<int> done(64, 0);
+  REQUIRE_THROWS_AS(runtime::ParallelFor(&thread_pool, done.size(), 8,
+                                         [&done](size_t i) {
+                                           if (i == 5) {
+                                             throw std::runtime_error("body");
+                                           }
+                                           done[i] = 1;
+                                         }),
+                    std::runtime_error);
+  REQUIRE(std::count(done.begin(), done.end(), 1) == 61);
+
+  thread_pool.Stop();
+}
+
+template <concepts::GaloisFieldElement Element, typename Engine,
+          size_t kMaxSize, typename RandomGen>
+void RunMulMiddleTest(RandomGen& random_gen) {
+  using NaivePoly = polynomial::NaivePolynomial<Element>;
+  constexpr size_t kTestsCount = 50;
+
+  for (size_t test = 0; test < kTestsCount; ++test) {
+    const auto first = GenPoly<NaivePoly, kMaxSize>(random_gen).Get();
+    const auto second = GenPoly<NaivePoly, kMaxSize>(random_gen).Get();
+    auto product = NaivePoly(first).Mul(NaivePoly(second)).Get();
+
+    const size_t from = random_gen() % product.size();
+    const size_t to = from + 1 + random_gen() % (product.size() - from);
+    std::vector<Element> expected(product.begin() + from,
+                                  product.begin() + to);
+    while (!expected.empty() && expected.back() == Element::Zero()) {
+      expected.pop_back();
+    }
+    REQUIRE(Engine::MulMiddle(first, second, from, to) == expected);
+  }
+}
+
+TEST_CASE("MulMiddle") {
+  std::mt19937 random_gen;
+
+  SECTION("Karatsuba") {
+    using GaloisField = galois_field::LogBasedField<2, 3, {1, 1, 0, 1}>;
+    using Element = galois_field::FieldElementWrapper<GaloisField>;
+    using Engine = polynomial::KaratsubaEngine<Element>;
+
+    RunMulMiddleTest<Element, Engine, 32>(random_gen);
+    RunMulMiddleTest<Element, Engine, 1000>(random_gen);
+  }
+
+  SECTION("NTT") {
+    using GaloisField = galois_field::PrimeRing<17>;
+    using Element = galois_field::FieldElementWrapper<GaloisField>;
+    using Engine = polynomial::NttEngine<Element>;
+
+    RunMulMiddleTest<Element, Engine, 32>(random_gen);
+    RunMulMiddleTest<Element, Engine, 1000>(random_gen);
+  }
+}
+
+template <concepts::GaloisFieldElement Element, typename Engine,
+          size_t kMaxSize, typename RandomGen>
+void RunMulManyTest(RandomGen& random_gen) {
+  using NaivePoly = polynomial::NaivePolynomial<Element>;
+  constexpr size_t kTestsCount = 20;
+
+  for (size_t test = 0; test < kTestsCount; ++test) {
+    const auto first = GenPoly<NaivePoly, kMaxSize>(random_gen);
+    std::vector<std::vector<Element>> others(1 + random_gen() % 4);
+    for (auto& other : others) {
+      other = GenPoly<NaivePoly, kMaxSize>(random_gen).Get();
+    }
+
+    const auto products = Engine::MulMany(first.Get(), others);
+    REQUIRE(products.size() == others.size());
+    for (size_t i = 0; i < others.size(); ++i) {
+      REQUIRE(products[i] == first.Mul(NaivePoly(others[i])).Get());
+    }
+  }
+}
+
+template <concepts::GaloisFieldElement Element, typename Engine,
+          size_t kMaxSize, typename RandomGen>
+void RunMulMatrixTest(RandomGen& random_gen) {
+  using NaivePoly = polynomial::NaivePolynomial<Element>;
+  constexpr size_t kTestsCount = 20;
+  constexpr size_t kRows = 2;
+  constexpr size_t kInner = 3;
+  constexpr size_t kColumns = 2;
+
+  for (size_t test = 0; test < kTestsCount; ++test) {
+    std::vector<std::vector<Element>> lhs(kRows * kInner);
+    std::vector<std::vector<Element>> rhs(kInner * kColumns);
+    std::vector<const std::vector<Element>*> lhs_entries;
+    std::vector<const std::vector<Element>*> rhs_entries;
+    for (auto& entry : lhs) {
+      entry = GenPoly<NaivePoly, kMaxSize>(random_gen).Get();
+      lhs_entries.push_back(&entry);
+    }
+    for (auto& entry : rhs) {
+      entry = GenPoly<NaivePoly, kMaxSize>(random_gen).Get();
+      rhs_entries.push_back(&entry);
+    }
+
+    const auto product = Engine::MulMatrix(lhs_entries, rhs_entries, kInner);
+    REQUIRE(product.size() == kRows * kColumns);
+    for (size_t i = 0; i < kRows; ++i) {
+      for (size_t k = 0; k < kColumns; ++k) {
+        NaivePoly expected;
+        for (size_t j = 0; j < kInner; ++j) {
+          expected = expected.Add(NaivePoly(lhs[i * kInner + j])
+                                      .Mul(NaivePoly(rhs[j * kColumns + k])));
+        }
+        REQUIRE(product[i * kColumns + k] == expected.Get());
+      }
+    }
+  }
+}
+
+TEST_CASE("Batched products") {
+  std::mt19937 random_gen;
+
+  SECTION("Karatsuba") {
+    using GaloisField = galois_field::LogBasedField<2, 3, {1, 1, 0, 1}>;
+    using Element = galois_field::FieldElementWrapper<GaloisField>;
+    using Engine = polynomial::KaratsubaEngine<Element>;
+
+    RunMulManyTest<Element, Engine, 300>(random_gen);
+  }
+
+  SECTION("NTT") {
+    using GaloisField = galois_field::PrimeRing<17>;
+    using Element = galois_field::FieldElementWrapper<GaloisField>;
+    using Engine = polynomial::NttEngine<Element>;
+
+    RunMulManyTest<Element, Engine, 300>(random_gen);
+    RunMulMatrixTest<Element, Engine, 32>(random_gen);
+    RunMulMatrixTest<Element, Engine, 300>(random_gen);
+  }
+
+  SECTION("Hybrid") {
+    using GaloisField = galois_field::PrimeRing<17>;
+    using Element = galois_field::FieldElementWrapper<GaloisField>;
+    using Engine = polynomial::HybridEngine<Element>;
+
+    RunMulManyTest<Element, Engine, 300>(random_gen);
+    RunMulMatrixTest<Element, Engine, 300>(random_gen);
+  }
+}
+
+template <concepts::Polynom Poly, size_t kMaxSize, typename RandomGen>
+void RunXGcdTest(RandomGen& random_gen) {
+  constexpr size_t kTestsCount = 20;
+
+  for (size_t test = 0; test < kTestsCount; ++test) {
+    const auto common = GenPoly<Poly, kMaxSize / 4>(random_gen);
+    const auto first = GenPoly<Poly, kMaxSize>(random_gen).Mul(common);
+    const auto second = GenPoly<Poly, kMaxSize>(random_gen).Mul(common);
+
+    const auto [gcd, s, t] = first.XGcd(second);
+    REQUIRE(gcd == first.Gcd(second));
+    REQUIRE(s.Mul(first).Add(t.Mul(second)) == gcd);
+
+    // operands of the same size
+    const auto shifted = first.Add(common);
+    const auto [same_gcd, same_s, same_t] = first.XGcd(shifted);
+    REQUIRE(same_gcd == first.Gcd(shifted));
+    REQUIRE(same_s.Mul(first).Add(same_t.Mul(shifted)) == same_gcd);
+
+    const auto mod = GenPoly<Poly, kMaxSize, kFixed>(random_gen);
+    const auto inverse = first.InvMod(mod);
+    if (first.Gcd(mod).IsOne()) {
+      REQUIRE(inverse.Mul(first).Rem(mod).IsOne());
+    } else {
+      REQUIRE(inverse.IsZero());
+    }
+  }
+}
+
+TEST_CASE("XGcd") {
+  std::mt19937 random_gen;
+
+  SECTION("Naive") {
+    using GaloisField = galois_field::PrimeRing<3>;
+    using Element = galois_field::FieldElementWrapper<GaloisField>;
+    using Poly = polynomial::NaivePolynomial<Element>;
+
+    RunXGcdTest<Poly, 16>(random_gen);
+    RunXGcdTest<Poly, 256>(random_gen);
+  }
+
+  SECTION("Karatsuba") {
+    using GaloisField = galois_field::LogBasedField<2, 3, {1, 1, 0, 1}>;
+    using Element = galois_field::FieldElementWrapper<GaloisField>;
+    using Engine = polynomial::KaratsubaEngine<Element>;
+    using Poly = polynomial::GenericPolynomial<Element, Engine>;
+
+    RunXGcdTest<Poly, 16>(random_gen);
+    RunXGcdTest<Poly, 1000>(random_gen);
+  }
+
+  SECTION("NTT") {
+    using GaloisField = galois_field::PrimeRing<17>;
+    using Element = galois_field::FieldElementWrapper<GaloisField>;
+    using Engine = polynomial::NttEngine<Element>;
+    using Poly = polynomial::GenericPolynomial<Element, Engine>;
+
+    RunXGcdTest<Poly, 16>(random_gen);
+    RunXGcdTest<Poly, 2000>(random_gen);
+  }
+}
+
+TEST_CASE("HybridEngine") {
+  std::mt19937 random_gen;
+
+  // Small crossover points, so every algorithm is used on small sizes.
+  constexpr polynomial::Thresholds kSmall{
+      .karatsuba = 4,
+      .ntt = 24,
+      .kronecker = 24,
+      .plain_division = 16,
+      .ntt_division = 24,
+      .half_gcd = 16,
+      .half_gcd_min = 64,
+  };
+
+  SECTION("Z_17") {
+    using GaloisField = galois_field::PrimeRing<17>;
+    using Element = galois_field::FieldElementWrapper<GaloisField>;
+    using NaivePoly = polynomial::NaivePolynomial<Element>;
+    using Engine = polynomial::HybridEngine<Element>;
+    using GenericPoly = polynomial::GenericPolynomial<Element, Engine>;
+
+    constexpr int kTestsCount = 20;
+
+    for (int test = 0; test < kTestsCount; ++test) {
+      RunCompareTest<NaivePoly, GenericPoly, 700>(random_gen);
+    }
+  }
+
+  SECTION("Z_17 small thresholds") {
+    using GaloisField = galois_field::PrimeRing<17>;
+    using Element = galois_field::FieldElementWrapper<GaloisField>;
+    using NaivePoly = polynomial::NaivePolynomial<Element>;
+    using Engine = polynomial::HybridEngine<Element, kSmall>;
+    using GenericPoly = polynomial::GenericPolynomial<Element, Engine>;
+
+    constexpr int kTestsCount = 200;
+
+    for (int test = 0; test < kTestsCount; ++test) {
+      RunCompareTest<NaivePoly, GenericPoly, 256>(random_gen);
+    }
+    RunMulMiddleTest<Element, Engine, 256>(random_gen);
+    RunXGcdTest<GenericPoly, 256>(random_gen);
+  }
+
+  SECTION("GF_2^3 Kronecker") {
+    using GaloisField = galois_field::LogBasedField<2, 3, {1, 1, 0, 1}>;
+    using Element = galois_field::FieldElementWrapper<GaloisField>;
+    using NaivePoly = polynomial::NaivePolynomial<Element>;
+    using Engine = polynomial::HybridEngine<Element, kSmall>;
+    using GenericPoly = polynomial::GenericPolynomial<Element, Engine>;
+
+    constexpr int kTestsCount = 200;
+
+    for (int test = 0; test < kTestsCount; ++test) {
+      RunCompareTest<NaivePoly, GenericPoly, 256>(random_gen);
+    }
+    RunXGcdTest<GenericPoly, 256>(random_gen);
+  }
+
+  SECTION("GF_3^2 Kronecker") {
+    using GaloisField = galois_field::LogBasedField<3, 2, {2, 2, 1}>;
+    using Element = galois_field::FieldElementWrapper<GaloisField>;
+    using NaivePoly = polynomial::NaivePolynomial<Element>;
+    using Engine = polynomial::HybridEngine<Element, kSmall>;
+    using GenericPoly = polynomial::GenericPolynomial<Element, Engine>;
+
+    constexpr int kTestsCount = 200;
+
+    for (int test = 0; test < kTestsCount; ++test) {
+      RunCompareTest<NaivePoly, GenericPoly, 256>(random_gen);
+    }
+  }
+
+  // Products of 700 coefficients below 998244353 do not fit into the NTT
+  // prime, Karatsuba must be used instead.
+  SECTION("Large prime") {
+    // NOLINTNEXTLINE
+    using GaloisField = galois_field::PrimeRing<998244353, uint64_t, __int128_t>;
+    using Element = galois_field::FieldElementWrapper<GaloisField>;
+    using NaivePoly = polynomial::NaivePolynomial<Element>;
+    using Engine = polynomial::HybridEngine<Element, kSmall>;
+    using GenericPoly = polynomial::GenericPolynomial<Element, Engine>;
+
+    constexpr int kTestsCount = 10;
+
+    for (int test = 0; test < kTestsCount; ++test) {
+      RunCompareTest<NaivePoly, GenericPoly, 700>(random_gen);
+    }
+  }
+}
+
+template <concepts::GaloisFieldElement Element, typename Engine,
+          size_t kMaxPoints, typename RandomGen>
+void RunSubproductTreeTest(RandomGen& random_gen,
+                           runtime::IScheduler* scheduler = nullptr) {
+  using NaivePoly = polynomial::NaivePolynomial<Element>;
+  constexpr size_t kTestsCount = 5;
+
+  auto horner = [](const std::vector<Element>& poly, const Element& point) {
+    Element result = Element::Zero();
+    for (size_t i = poly.size(); i-- > 0;) {
+      result = result * point + poly[i];
+    }
+    return result;
+  };
+
+  for (size_t test = 0; test < kTestsCount; ++test) {
+    std::vector<Element> points(1 + random_gen() % kMaxPoints);
+    for (auto& point : points) {
+      point = GenElement<Element>(random_gen);
+    }
+    std::sort(points.begin(), points.end());
+    points.erase(std::unique(points.begin(), points.end()), points.end());
+    std::shuffle(points.begin(), points.end(), random_gen);
+
+    const polynomial::SubproductTree<Element, Engine> tree(points, scheduler);
+    for (const auto& point : points) {
+      REQUIRE(horner(tree.Root(), point) == Element::Zero());
+    }
+
+    const auto poly = GenPoly<NaivePoly, 3 * kMaxPoints>(random_gen).Get();
+    const auto values = tree.Evaluate(poly);
+    REQUIRE(values.size() == points.size());
+    for (size_t i = 0; i < points.size(); ++i) {
+      REQUIRE(values[i] == horner(poly, points[i]));
+    }
+
+    std::vector<Element> targets(points.size());
+    for (auto& target : targets) {
+      target = GenElement<Element>(random_gen);
+    }
+    const auto interpolated = tree.Interpolate(targets);
+    REQUIRE(interpolated.size() <= points.size());
+    REQUIRE(tree.Evaluate(interpolated) == targets);
+  }
+}
+
+TEST_CASE("SubproductTree") {
+  std::mt19937 random_gen;
+
+  SECTION("GF_2^8 Karatsuba") {
+    // NOLINTNEXTLINE
+    using GaloisField = galois_field::LogBasedField<2, 8, {1, 0, 1, 1, 1, 0, 0, 0, 1}>;
+    using Element = galois_field::FieldElementWrapper<GaloisField>;
+    using Engine = polynomial::KaratsubaEngine<Element>;
+
+    RunSubproductTreeTest<Element, Engine, 10>(random_gen);
+    RunSubproductTreeTest<Element, Engine, 300>(random_gen);
+  }
+
+  SECTION("Z_1000003 Hybrid") {
+    using GaloisField = galois_field::PrimeRing<1000003, uint64_t, __int128_t>;
+    using Element = galois_field::FieldElementWrapper<GaloisField>;
+    using Engine = polynomial::HybridEngine<Element>;
+
+    RunSubproductTreeTest<Element, Engine, 2000>(random_gen);
+  }
+
+  SECTION("Z_1000003 parallel") {
+    using GaloisField = galois_field::PrimeRing<1000003, uint64_t, __int128_t>;
+    using Element = galois_field::FieldElementWrapper<GaloisField>;
+    using Engine = polynomial::HybridEngine<Element>;
+
+    runtime::ThreadPool thread_pool(4);
+    thread_pool.Start();
+    RunSubproductTreeTest<Element, Engine, 2000>(random_gen, &thread_pool);
+    thread_pool.Stop();
+  }
 }
@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <array>
 #include <cstdint>
 #include <map>
 #include <random>
@@ -10,11 +11,15 @@
 #include <factorization/concepts.hpp>
 #include <factorization/galois_field/log_based_field.hpp>
 #include <factorization/galois_field/field_element_wrapper.hpp>
+#include <factorization/galois_field/prime_ring.hpp>
 #include <factorization/polynomial/generic_polynomial.hpp>
 #include <factorization/polynomial/karatsuba_engine.hpp>
 #include <factorization/polynomial/naive_polynomial.hpp>
 #include <factorization/solver/berlekamp.hpp>
 #include <factorization/solver/distinct_degree_factorization.hpp>
+#include <factorization/solver/equal_degree_factorization.hpp>
+#include <factorization/solver/factorizer.hpp>
+#include <factorization/solver/root_finding.hpp>
 #include <factorization/solver/square_free_factorization.hpp>
 
 #include "generator.hpp"
@@ -155,6 +160,43 @@ TEST_CASE("Berlekamp") {
       REQUIRE(poly == check);
     }
   }
+
+  SECTION("LargeField") {
+    // Too large to try every field element, so factors are split by random
+    // elements of the Berlekamp subalgebra.
+    using GaloisField = galois_field::PrimeRing<1000003, uint64_t, __int128_t>;
+    using Element = galois_field::FieldElementWrapper<GaloisField>;
+    using Engine = polynomial::KaratsubaEngine<Element>;
+    using Poly = polynomial::GenericPolynomial<Element, Engine>;
+
+    constexpr int kTestsCount = 20;
+    constexpr int kRootsCount = 30;
+
+    solver::Berlekamp<Poly> solver;
+
+    for (int test = 0; test < kTestsCount; ++test) {
+      auto poly = GenPoly<Poly, 60>(random_gen).MakeMonic();
+      // Many linear factors need many splitting rounds.
+      for (int i = 0; i < kRootsCount; ++i) {
+        const auto root = utils::RandomElement<Element>(random_gen);
+        poly = std::move(poly).Mul(
+            Poly(std::vector<Element>{-root, Element::One()}));
+      }
+
+      auto check = Poly(Element::One());
+
+      for (const auto& factor : solver.Factorize(poly, random_gen)) {
+        auto got = solver.Factorize(factor.factor, random_gen);
+        std::vector<solver::Factor<Poly>> expected(
+            1, solver::Factor<Poly>(factor.factor, 1));
+
+        REQUIRE(got == expected);
+
+        check = std::move(check).Mul(BinPow(factor.factor, factor.power));
+      }
+      REQUIRE(poly == check);
+    }
+  }
 }
 
 TEST_CASE("DistinctDegreeFactorization") {
@@ -291,3 +333,287 @@ TEST_CASE("DistinctDegreeFactorizationStressAgainstNaive") {
   run_stress
       .template operator()<galois_field::LogBasedField<3, 2, {2, 2, 1}>>();
 }
+
+// Multiplies products of x - r over random roots r, some of them repeated,
+// by a random cofactor whose roots are found by brute force.
+template <concepts::Polynom Poly, size_t kRoots, size_t kCofactorSize,
+          typename RandomGen>
+void RunFindRootsTest(RandomGen& random_gen, roots::RootsMethod method) {
+  using Element = typename Poly::Element;
+  constexpr int kTestCount = 5;
+
+  for (int test = 0; test < kTestCount; ++test) {
+    std::vector<Element> expected;
+    Poly poly = GenPoly<Poly, kCofactorSize>(random_gen);
+    for (const auto& element : Element::AllFieldElements()) {
+      const auto coefficients = poly.Get();
+      Element value = Element::Zero();
+      for (size_t i = coefficients.size(); i-- > 0;) {
+        value = value * element + coefficients[i];
+      }
+      if (value == Element::Zero()) {
+        expected.push_back(element);
+      }
+    }
+    for (size_t i = 0; i < kRoots; ++i) {
+      const Element root = GenElement<Element>(random_gen);
+      const Poly linear(std::vector<Element>{-root, Element::One()});
+      poly = std::move(poly).Mul(linear);
+      if (random_gen() % 4 == 0) {
+        poly = std::move(poly).Mul(linear);
+      }
+      expected.push_back(root);
+    }
+    std::sort(expected.begin(), expected.end());
+    expected.erase(std::unique(expected.begin(), expected.end()),
+                   expected.end());
+
+    REQUIRE(roots::FindRoots(poly, random_gen, method) == expected);
+  }
+}
+
+TEST_CASE("FindRoots") {
+  std::mt19937 random_gen;
+  constexpr std::array kMethods{roots::RootsMethod::kAuto,
+                                roots::RootsMethod::kSplit,
+                                roots::RootsMethod::kEvaluate};
+
+  SECTION("Z_2") {
+    using GaloisField = galois_field::LogBasedField<2, 1, {1, 1}>;
+    using Element = galois_field::FieldElementWrapper<GaloisField>;
+    using Poly = polynomial::NaivePolynomial<Element>;
+
+    for (const auto method : kMethods) {
+      RunFindRootsTest<Poly, 2, 10>(random_gen, method);
+    }
+  }
+
+  SECTION("GF_2^8") {
+    // NOLINTNEXTLINE
+    using GaloisField = galois_field::LogBasedField<2, 8, {1, 0, 1, 1, 1, 0, 0, 0, 1}>;
+    using Element = galois_field::FieldElementWrapper<GaloisField>;
+    using Engine = polynomial::KaratsubaEngine<Element>;
+    using Poly = polynomial::GenericPolynomial<Element, Engine>;
+
+    for (const auto method : kMethods) {
+      RunFindRootsTest<Poly, 30, 40>(random_gen, method);
+    }
+  }
+
+  SECTION("GF_3^2") {
+    using GaloisField = galois_field::LogBasedField<3, 2, {2, 2, 1}>;
+    using Element = galois_field::FieldElementWrapper<GaloisField>;
+    using Poly = polynomial::NaivePolynomial<Element>;
+
+    for (const auto method : kMethods) {
+      RunFindRootsTest<Poly, 5, 20>(random_gen, method);
+    }
+  }
+
+  SECTION("Z_1000003") {
+    using GaloisField = galois_field::PrimeRing<1000003, uint64_t, __int128_t>;
+    using Element = galois_field::FieldElementWrapper<GaloisField>;
+    using Engine = polynomial::KaratsubaEngine<Element>;
+    using Poly = polynomial::GenericPolynomial<Element, Engine>;
+
+    RunFindRootsTest<Poly, 100, 10>(random_gen, roots::RootsMethod::kAuto);
+  }
+}
+
+// Splits every DDF entry of square-free parts of random polynomials, with and
+// without the Frobenius tables of the DDF run, and checks that the factors have
+// the entry's degree and multiply back to the entry.
+template <concepts::Polynom Poly, size_t kMaxSize, typename RandomGen>
+void RunEqualDegreeTest(RandomGen& random_gen) {
+  constexpr int kTestCount = 5;
+
+  auto check = [](const std::vector<Poly>& factors, const Poly& factor,
+                  int degree) {
+    REQUIRE(factors.size() * degree == factor.Size() - 1);
+    Poly product(Poly::Element::One());
+    for (const auto& irreducible : factors) {
+      REQUIRE(irreducible.Size() == static_cast<size_t>(degree) + 1);
+      product = std::move(product).Mul(irreducible);
+    }
+    REQUIRE(product == factor);
+  };
+
+  for (int test = 0; test < kTestCount; ++test) {
+    const Poly poly = GenPoly<Poly, kMaxSize>(random_gen);
+    for (const auto& [part, _] : sff::SquareFreeFactorize(poly)) {
+      const Poly square_free = part.MakeMonic();
+      if (square_free.IsOne()) {
+        continue;
+      }
+      ddf::ntl_like::DistinctDegreeFactorizer<Poly> ntl_like(square_free);
+      ddf::own_tree::DistinctDegreeFactorizer<Poly, ddf::kExactNtl> own_tree(
+          square_free);
+      (void)own_tree.Run();
+      for (const auto& [factor, degree] : ntl_like.Run()) {
+        check(edf::EqualDegreeFactorize(factor, degree, random_gen), factor,
+              degree);
+        check(edf::EqualDegreeFactorize(factor, degree, ntl_like.Frobenius(),
+                                        random_gen),
+              factor, degree);
+        check(edf::EqualDegreeFactorize(factor, degree, own_tree.Frobenius(),
+                                        random_gen),
+              factor, degree);
+      }
+    }
+  }
+}
+
+TEST_CASE("EqualDegreeFactorization") {
+  std::mt19937 random_gen;
+
+  SECTION("KnownFactors") {
+    using GaloisField = galois_field::LogBasedField<2, 1, {1, 1}>;
+    using Element = galois_field::FieldElementWrapper<GaloisField>;
+    using Engine = polynomial::KaratsubaEngine<Element>;
+    using Poly = polynomial::GenericPolynomial<Element, Engine>;
+
+    const Poly degree_4_a(std::vector<int>{1, 1, 0, 0, 1});
+    const Poly degree_4_b(std::vector<int>{1, 0, 0, 1, 1});
+    const Poly degree_4_c(std::vector<int>{1, 1, 1, 1, 1});
+
+    auto factors = edf::EqualDegreeFactorize(
+        degree_4_a.Mul(degree_4_b).Mul(degree_4_c), 4, random_gen);
+    REQUIRE(factors.size() == 3);
+    std::sort(factors.begin(), factors.end(),
+              [](const Poly& lhs, const Poly& rhs) {
+                return std::ranges::lexicographical_compare(lhs.View(),
+                                                            rhs.View());
+              });
+    REQUIRE(factors[0] == degree_4_b);
+    REQUIRE(factors[1] == degree_4_a);
+    REQUIRE(factors[2] == degree_4_c);
+  }
+
+  SECTION("Z_2") {
+    using GaloisField = galois_field::LogBasedField<2, 1, {1, 1}>;
+    using Element = galois_field::FieldElementWrapper<GaloisField>;
+    using Engine = polynomial::KaratsubaEngine<Element>;
+    using Poly = polynomial::GenericPolynomial<Element, Engine>;
+
+    RunEqualDegreeTest<Poly, 200>(random_gen);
+  }
+
+  SECTION("GF_2^8") {
+    // NOLINTNEXTLINE
+    using GaloisField = galois_field::LogBasedField<2, 8, {1, 0, 1, 1, 1, 0, 0, 0, 1}>;
+    using Element = galois_field::FieldElementWrapper<GaloisField>;
+    using Engine = polynomial::KaratsubaEngine<Element>;
+    using Poly = polynomial::GenericPolynomial<Element, Engine>;
+
+    RunEqualDegreeTest<Poly, 60>(random_gen);
+  }
+
+  SECTION("GF_3^2") {
+    using GaloisField = galois_field::LogBasedField<3, 2, {2, 2, 1}>;
+    using Element = galois_field::FieldElementWrapper<GaloisField>;
+    using Poly = polynomial::NaivePolynomial<Element>;
+
+    RunEqualDegreeTest<Poly, 60>(random_gen);
+  }
+
+  SECTION("Z_1000003") {
+    using GaloisField = galois_field::PrimeRing<1000003, uint64_t, __int128_t>;
+    using Element = galois_field::FieldElementWrapper<GaloisField>;
+    using Engine = polynomial::KaratsubaEngine<Element>;
+    using Poly = polynomial::GenericPolynomial<Element, Engine>;
+
+    RunEqualDegreeTest<Poly, 60>(random_gen);
+  }
+}
+
+// Factorizes random polynomials with the automatic and every fixed plan and
+// checks that the factors are irreducible, multiply back to the input and match
+// Berlekamp.
+template <concepts::Polynom Poly, size_t kMaxSize, typename RandomGen>
+void RunFactorizerTest(RandomGen& random_gen) {
+  using solver::FactorizationMethod;
+  using solver::FactorizationPlan;
+  constexpr int kTestCount = 5;
+
+  auto sorted = [](std::vector<solver::Factor<Poly>> factors) {
+    std::sort(factors.begin(), factors.end(),
+              [](const auto& lhs, const auto& rhs) {
+                if (lhs.power != rhs.power) {
+                  return lhs.power < rhs.power;
+                }
+                return std::ranges::lexicographical_compare(lhs.factor.View(),
+                                                            rhs.factor.View());
+              });
+    return factors;
+  };
+
+  std::vector<solver::Factorizer<Poly>> factorizers = {
+      solver::Factorizer<Poly>(),
+      solver::Factorizer<Poly>(
+          FactorizationPlan{FactorizationMethod::kDistinctDegree,
+                            ddf::kSmallField}),
+      solver::Factorizer<Poly>(FactorizationPlan{
+          FactorizationMethod::kDistinctDegree, ddf::kExactNtl}),
+      solver::Factorizer<Poly>(
+          FactorizationPlan{FactorizationMethod::kBerlekamp})};
+
+  for (int test = 0; test < kTestCount; ++test) {
+    const Poly poly = GenPoly<Poly, kMaxSize>(random_gen);
+    std::vector<solver::Factor<Poly>> expected;
+    for (const auto& factorizer : factorizers) {
+      auto factors = sorted(factorizer.Factorize(poly, random_gen));
+      Poly product(Poly::Element::One());
+      for (const auto& [factor, power] : factors) {
+        const auto components = ddf::naive::DistinctDegreeFactorize(factor);
+        REQUIRE(components.size() == 1);
+        REQUIRE(components[0].factor == factor);
+        product = std::move(product).Mul(BinPow(factor, power));
+      }
+      REQUIRE(product == poly.MakeMonic());
+      if (expected.empty()) {
+        expected = sorted(solver::Berlekamp<Poly>().Factorize(poly));
+      }
+      REQUIRE(factors == expected);
+    }
+  }
+}
+
+TEST_CASE("Factorizer") {
+  std::mt19937 random_gen;
+
+  SECTION("Z_2") {
+    using GaloisField = galois_field::LogBasedField<2, 1, {1, 1}>;
+    using Element = galois_field::FieldElementWrapper<GaloisField>;
+    using Engine = polynomial::KaratsubaEngine<Element>;
+    using Poly = polynomial::GenericPolynomial<Element, Engine>;
+
+    RunFactorizerTest<Poly, 150>(random_gen);
+  }
+
+  SECTION("GF_2^8") {
+    // NOLINTNEXTLINE
+    using GaloisField = galois_field::LogBasedField<2, 8, {1, 0, 1, 1, 1, 0, 0, 0, 1}>;
+    using Element = galois_field::FieldElementWrapper<GaloisField>;
+    using Engine = polynomial::KaratsubaEngine<Element>;
+    using Poly = polynomial::GenericPolynomial<Element, Engine>;
+
+    RunFactorizerTest<Poly, 40>(random_gen);
+  }
+
+  SECTION("GF_3^2") {
+    using GaloisField = galois_field::LogBasedField<3, 2, {2, 2, 1}>;
+    using Element = galois_field::FieldElementWrapper<GaloisField>;
+    using Poly = polynomial::NaivePolynomial<Element>;
+
+    RunFactorizerTest<Poly, 40>(random_gen);
+  }
+
+  SECTION("Z_1000003") {
+    using GaloisField = galois_field::PrimeRing<1000003, uint64_t, __int128_t>;
+    using Element = galois_field::FieldElementWrapper<GaloisField>;
+    using Engine = polynomial::KaratsubaEngine<Element>;
+    using Poly = polynomial::GenericPolynomial<Element, Engine>;
+
+    RunFactorizerTest<Poly, 40>(random_gen);
+  }
+}